@@ -0,0 +1,136 @@
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <cmath>
+
+#include "physics/physicbvh.h"
+#include "physics/physicvbo.h"
+#include "checks.h"
+
+namespace {
+
+struct Hit final {
+  float fraction = 1.f;
+  int   part     = -1;
+  int   triangle = -1;
+  };
+
+struct RayCallback final : btTriangleRaycastCallback {
+  RayCallback(const btVector3& from, const btVector3& to):btTriangleRaycastCallback(from,to) {}
+
+  btScalar reportHit(const btVector3&, btScalar hitFraction, int partId, int triangleIndex) override {
+    if(hitFraction<hit.fraction) {
+      hit.fraction = float(hitFraction);
+      hit.part     = partId;
+      hit.triangle = triangleIndex;
+      }
+    return hitFraction;
+    }
+
+  Hit hit;
+  };
+
+// hilly grid terrain in meters, large enough to go through the disk cache
+struct Terrain final {
+  static constexpr int Size = 64;
+
+  Terrain() {
+    for(int z=0; z<=Size; ++z)
+      for(int x=0; x<=Size; ++x) {
+        float y = std::sin(float(x)*0.37f)*2.f + std::cos(float(z)*0.23f)*3.f;
+        vert.emplace_back(float(x),y,float(z));
+        }
+    for(int z=0; z<Size; ++z)
+      for(int x=0; x<Size; ++x) {
+        uint32_t i = uint32_t(z*(Size+1)+x);
+        index.insert(index.end(),{i, i+uint32_t(Size+1), i+1, i+1, i+uint32_t(Size+1), i+uint32_t(Size+2)});
+        }
+    vbo.reset(new PhysicVbo(&vert));
+    vbo->addIndex(index,0,index.size()/2,phoenix::material_group::earth);
+    vbo->addIndex(index,index.size()/2,index.size()/2,phoenix::material_group::stone);
+    }
+
+  std::vector<btVector3>     vert;
+  std::vector<uint32_t>      index;
+  std::unique_ptr<PhysicVbo> vbo;
+  };
+
+struct Landscape final {
+  explicit Landscape(PhysicVbo& vbo) {
+    shape.reset(new btMultimaterialTriangleMeshShape(&vbo,vbo.useQuantization(),false));
+    bvh = PhysicBvh::attach(*shape,vbo,vbo.useQuantization());
+    }
+
+  Hit rayTest(const btVector3& from, const btVector3& to) const {
+    RayCallback cb(from,to);
+    shape->performRaycast(&cb,from,to);
+    return cb.hit;
+    }
+
+  // restored bvh must outlive the shape
+  std::unique_ptr<PhysicBvh>                        bvh;
+  std::unique_ptr<btMultimaterialTriangleMeshShape> shape;
+  };
+
+}
+
+bool bvhCacheCheck() {
+  auto dir = std::filesystem::temp_directory_path()/"opengothic-checks-bvh";
+  std::error_code ec;
+  std::filesystem::remove_all(dir,ec);
+
+  bool ok     = true;
+  auto expect = [&ok](bool v, const char* what) {
+    if(!v) {
+      std::printf("  %s\n",what);
+      ok = false;
+      }
+    };
+
+  PhysicBvh::setCacheDir(dir.u16string());
+
+  Terrain terrain;
+  expect(terrain.vbo->triangleCount()>=2048, "terrain is too small for the cache");
+
+  CheckTimer tBuild;
+  Landscape  built(*terrain.vbo);
+  double     buildMs = tBuild.ms();
+  expect(built.bvh==nullptr, "first attach must build the bvh");
+
+  CheckTimer tLoad;
+  Landscape  loaded(*terrain.vbo);
+  double     loadMs = tLoad.ms();
+  expect(loaded.bvh!=nullptr, "second attach must restore the bvh from disk");
+
+  // vertical and slanted rays across the whole terrain, including misses beyond the edge
+  size_t rays = 0, hits = 0, mismatch = 0;
+  const float ext = float(Terrain::Size);
+  for(int i=-4; i<=Terrain::Size+4; ++i)
+    for(int r=-4; r<=Terrain::Size+4; r+=3) {
+      const btVector3 from[] = {
+        btVector3(float(i)+0.31f,  20.f, float(r)+0.17f),
+        btVector3(-2.f,            10.f, float(i)+0.5f),
+        };
+      const btVector3 to[] = {
+        btVector3(float(i)+0.31f, -20.f, float(r)+0.17f),
+        btVector3(ext+2.f, float(r-Terrain::Size/2)*0.25f, float(Terrain::Size-i)+0.5f),
+        };
+      for(size_t k=0; k<2; ++k) {
+        Hit a = built .rayTest(from[k],to[k]);
+        Hit b = loaded.rayTest(from[k],to[k]);
+        ++rays;
+        if(a.triangle>=0)
+          ++hits;
+        if(a.triangle!=b.triangle || a.part!=b.part || a.fraction!=b.fraction)
+          ++mismatch;
+        }
+      }
+  std::printf("  %zu rays, %zu hits, %zu mismatches\n",rays,hits,mismatch);
+  expect(hits>0,       "rays must hit the terrain");
+  expect(mismatch==0,  "restored bvh must give the same ray hits as a built one");
+  std::printf("  %zu triangles: build %.2f ms, load %.2f ms\n",terrain.vbo->triangleCount(),buildMs,loadMs);
+
+  PhysicBvh::setCacheDir(u"");
+  std::filesystem::remove_all(dir,ec);
+  return ok;
+  }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+struct Check final {
+  const char* name;
+  bool      (*func)();
+  };
+
+bool mem32Bench();
+bool pfxBench();
+bool lightBench();
+bool textureCacheCheck();
+bool dlsRender();
+bool mixerCheck();
+bool bvhCacheCheck();
+bool crowdBench();
+bool physicsDeterminism();
+bool stepListCheck();
+bool workersBench();
+
+class CheckTimer final {
+  public:
+    CheckTimer():start(std::chrono::steady_clock::now()) {}
+
+    double ms() const {
+      auto dt = std::chrono::steady_clock::now()-start;
+      return std::chrono::duration<double,std::milli>(dt).count();
+      }
+
+  private:
+    std::chrono::steady_clock::time_point start;
+  };
@@ -0,0 +1,144 @@
+#include <Tempest/Vec>
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "physics/cellgrid.h"
+#include "checks.h"
+
+using namespace Tempest;
+
+namespace {
+
+// layout of DynamicWorld::NpcBody, as seen by the grid
+struct Body final {
+  Vec3     pos;
+  float    r      = 0;
+  uint64_t cell   = 0;
+  size_t   cellId = 0, allId = 0;
+  };
+
+bool overlaps(const Body& a, const Body& b) {
+  if(&a==&b)
+    return false;
+  const float dx = a.pos.x-b.pos.x, dz = a.pos.z-b.pos.z, r = a.r+b.r;
+  return dx*dx+dz*dz<=r*r;
+  }
+
+}
+
+bool crowdBench() {
+  // crowds around a few towns plus wanderers; NpcBodyList::cellSize and NpcBody radii
+  const float  cellSize = 256.f;
+  const size_t count    = 2048;
+  const size_t frames   = 120;
+  const float  maxR     = 45.f;
+
+  std::mt19937                          rnd(7);
+  std::normal_distribution<float>       town(0.f,600.f);
+  std::uniform_real_distribution<float> world(-20000.f,20000.f);
+  std::uniform_real_distribution<float> step(-20.f,20.f);
+  const Vec3 towns[] = {Vec3(0,0,0), Vec3(8000,0,-3000), Vec3(-12000,0,9000), Vec3(4000,0,15000)};
+
+  std::vector<Body> body(count);
+  CellGrid<Body>    grid(cellSize);
+  for(size_t i=0; i<count; ++i) {
+    auto& b = body[i];
+    if(i%8==0) {
+      b.pos = Vec3(world(rnd),0,world(rnd));
+      } else {
+      auto& t = towns[i%4];
+      b.pos = Vec3(t.x+town(rnd),0,t.z+town(rnd));
+      }
+    b.r = 20.f+float(i%6)*4.f;
+    grid.add(b);
+    }
+
+  // SoA copy for the linear scan: the layout a SIMD broadphase would use
+  std::vector<float> px(count), pz(count), pr(count);
+
+  bool   ok       = true;
+  size_t hitGrid  = 0, hitScan = 0, visited = 0;
+  double msGrid   = 0, msScan  = 0, msMove = 0;
+  for(size_t f=0; f<frames; ++f) {
+    {
+    CheckTimer t;
+    for(auto& b:body) {
+      b.pos.x += step(rnd);
+      b.pos.z += step(rnd);
+      grid.onMove(b);
+      }
+    msMove += t.ms();
+    }
+
+    {
+    CheckTimer t;
+    for(auto& b:body) {
+      const float dX = maxR+b.r;
+      grid.query(b.pos.x-dX, b.pos.z-dX, b.pos.x+dX, b.pos.z+dX, [&](Body& o) {
+        ++visited;
+        if(overlaps(b,o))
+          ++hitGrid;
+        });
+      }
+    msGrid += t.ms();
+    }
+
+    {
+    CheckTimer t;
+    for(size_t i=0; i<count; ++i) {
+      px[i] = body[i].pos.x;
+      pz[i] = body[i].pos.z;
+      pr[i] = body[i].r;
+      }
+    for(size_t i=0; i<count; ++i) {
+      const float x = px[i], z = pz[i], r = pr[i];
+      size_t      n = 0;
+      for(size_t j=0; j<count; ++j) {
+        const float dx = x-px[j], dz = z-pz[j], rr = r+pr[j];
+        n += (dx*dx+dz*dz<=rr*rr) ? 1 : 0;
+        }
+      hitScan += n-1; // self
+      }
+    msScan += t.ms();
+    }
+  }
+
+  std::printf("  %zu bodies, %zu frames: grid %zu cells, %.1f candidates/query\n",
+              count,frames,grid.cellCount(),double(visited)/double(count*frames));
+  std::printf("  move %.2f ms, grid query %.2f ms, linear SoA scan %.2f ms (%.1fx)\n",
+              msMove,msGrid,msScan,msScan/std::max(msGrid,1e-3));
+  if(hitGrid!=hitScan) {
+    std::printf("  overlap count mismatch: grid %zu, scan %zu\n",hitGrid,hitScan);
+    ok = false;
+    }
+
+  // cells are released, once the last body leaves them
+  for(auto& b:body) {
+    b.pos.x += 100000.f;
+    grid.onMove(b);
+    }
+  for(auto& b:body) {
+    b.pos.x -= 100000.f;
+    grid.onMove(b);
+    }
+  if(grid.cellCount()>count) {
+    std::printf("  empty cells are not released: %zu cells\n",grid.cellCount());
+    ok = false;
+    }
+
+  for(size_t i=0; i<count; i+=2)
+    ok &= grid.del(body[i]);
+  ok &= !grid.del(body[0]);
+  size_t id = 0;
+  for(auto i:grid)
+    ok &= (i->allId==id++);
+  for(size_t i=1; i<count; i+=2)
+    ok &= grid.del(body[i]);
+  if(grid.size()!=0 || grid.cellCount()!=0) {
+    std::printf("  grid is not empty after removing all bodies\n");
+    ok = false;
+    }
+  return ok;
+  }
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "dmusic/dlscollection.h"
+#include "dmusic/soundfont.h"
+#include "dmusic/riff.h"
+#include "checks.h"
+
+using namespace Dx8;
+
+namespace {
+
+class RiffWriter final {
+  public:
+    size_t begin(const char* id, const char* list = nullptr) {
+      put(id,4);
+      const size_t at = out.size();
+      put32(0);
+      if(list!=nullptr)
+        put(list,4);
+      return at;
+      }
+
+    void end(size_t at) {
+      const uint32_t size = uint32_t(out.size()-at-4);
+      std::memcpy(&out[at],&size,4);
+      if(out.size()%2)
+        out.push_back(0);
+      }
+
+    void chunk(const char* id, const void* data, size_t size) {
+      const size_t at = begin(id);
+      put(data,size);
+      end(at);
+      }
+
+    std::vector<uint8_t> out;
+
+  private:
+    void put(const void* data, size_t size) {
+      auto* d = reinterpret_cast<const uint8_t*>(data);
+      out.insert(out.end(),d,d+size);
+      }
+    void put32(uint32_t v) { put(&v,4); }
+  };
+
+}
+
+// one instrument with a looped sine wave, over the whole key range
+static std::vector<uint8_t> mkCollection() {
+  const size_t         period = 100;
+  std::vector<int16_t> pcm(period*40);
+  for(size_t i=0; i<pcm.size(); ++i)
+    pcm[i] = int16_t(std::sin(float(i%period)*6.2831853f/float(period))*12000.f);
+
+  RiffWriter w;
+  auto dls = w.begin("RIFF","DLS ");
+
+  auto wvpl = w.begin("LIST","wvpl");
+  auto wave = w.begin("LIST","wave");
+  Wave::WaveFormat fmt;
+  fmt.wFormatTag       = Wave::PCM;
+  fmt.wChannels        = 1;
+  fmt.dwSamplesPerSec  = SoundFont::SampleRate;
+  fmt.dwAvgBytesPerSec = SoundFont::SampleRate*2;
+  fmt.wBlockAlign      = 2;
+  fmt.wBitsPerSample   = 16;
+  uint8_t fmtData[sizeof(fmt)+2] = {};
+  std::memcpy(fmtData,&fmt,sizeof(fmt));
+  w.chunk("fmt ",fmtData,sizeof(fmtData));
+  w.chunk("data",pcm.data(),pcm.size()*sizeof(int16_t));
+  w.end(wave);
+  w.end(wvpl);
+
+  auto lins = w.begin("LIST","lins");
+  auto ins  = w.begin("LIST","ins ");
+  DlsCollection::InstrumentHeader insh;
+  insh.cRegions = 1;
+  w.chunk("insh",&insh,sizeof(insh));
+  auto lrgn = w.begin("LIST","lrgn");
+  auto rgn  = w.begin("LIST","rgn ");
+  DlsCollection::RegionHeader rgnh;
+  rgnh.RangeKey.usLow  = 0;
+  rgnh.RangeKey.usHigh = 127;
+  w.chunk("rgnh",&rgnh,sizeof(rgnh));
+  DlsCollection::WaveSample     wsmp;
+  DlsCollection::WaveSampleLoop loop;
+  wsmp.cbSize        = sizeof(wsmp);
+  wsmp.usUnityNote   = 60;
+  wsmp.cSampleLoops  = 1;
+  loop.cbSize        = sizeof(loop);
+  loop.ulLoopStart   = uint32_t(period);
+  loop.ulLoopLength  = uint32_t(pcm.size()-2*period);
+  uint8_t wsmpData[sizeof(wsmp)+sizeof(loop)] = {};
+  std::memcpy(wsmpData,&wsmp,sizeof(wsmp));
+  std::memcpy(wsmpData+sizeof(wsmp),&loop,sizeof(loop));
+  w.chunk("wsmp",wsmpData,sizeof(wsmpData));
+  DlsCollection::WaveLink wlnk;
+  w.chunk("wlnk",&wlnk,sizeof(wlnk));
+  w.end(rgn);
+  w.end(lrgn);
+  w.end(ins);
+  w.end(lins);
+
+  w.end(dls);
+  return std::move(w.out);
+  }
+
+// overlapping chords, more than SoundFont::MaxVoices at peak; returns interleaved stereo
+static std::vector<float> renderPattern(const DlsCollection& dls, bool& drained) {
+  const size_t steps = 400;
+  const size_t frame = 441; // 10ms
+  const size_t hold  = 12;
+
+  SoundFont                      sf = dls.toSoundfont(0);
+  std::vector<SoundFont::Ticket> notes;
+  std::vector<float>             out((steps+100)*frame*2,0.f);
+
+  for(size_t s=0; s<steps+100; ++s) {
+    if(s<steps) {
+      for(uint8_t n=0; n<3; ++n)
+        notes.push_back(sf.noteOn(uint8_t(40+(s*7+n*4)%40),uint8_t(64+n*20)));
+      }
+    while(notes.size()>=hold*3 || (s>=steps && !notes.empty())) {
+      SoundFont::noteOff(notes.front());
+      notes.erase(notes.begin());
+      }
+    sf.mix(out.data()+s*frame*2,frame);
+    }
+  drained = !sf.hasNotes();
+  return out;
+  }
+
+bool dlsRender() {
+  auto riffData = mkCollection();
+  Riff riff(riffData.data(),riffData.size());
+
+  CheckTimer    tLoad;
+  DlsCollection dls(riff);
+  const double  msLoad = tLoad.ms();
+
+  bool       drained0 = false, drained1 = false;
+  CheckTimer tRender;
+  auto       a = renderPattern(dls,drained0);
+  const double msRender = tRender.ms();
+  auto       b = renderPattern(dls,drained1);
+
+  bool  ok   = true;
+  float peak = 0;
+  for(auto v:a) {
+    if(!std::isfinite(v)) {
+      ok = false;
+      break;
+      }
+    peak = std::max(peak,std::abs(v));
+    }
+
+  if(!ok)
+    std::printf("  output has non-finite samples\n");
+  if(peak<=0.f) {
+    std::printf("  output is silent\n");
+    ok = false;
+    }
+  if(!drained0 || !drained1) {
+    std::printf("  voices are still playing after all note-offs\n");
+    ok = false;
+    }
+  if(a!=b) {
+    // voice pools share preset table: a second instrument must not observe state of the first one
+    std::printf("  render is not deterministic\n");
+    ok = false;
+    }
+
+  const double seconds = double(a.size()/2)/double(SoundFont::SampleRate);
+  std::printf("  collection load: %.2f ms\n",msLoad);
+  std::printf("  render: %.2f ms for %.1f s of audio (peak %.3f)\n",msRender,seconds,double(peak));
+  return ok;
+  }
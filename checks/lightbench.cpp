@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "graphics/dynamic/frustrum.h"
+#include "graphics/lightlist.h"
+#include "checks.h"
+
+using namespace Tempest;
+
+namespace {
+
+// 90 degree view from 'at' towards yaw, looking slightly down
+Frustrum view(const Vec3& at, float yaw, float zFar) {
+  const Vec3 d  = Vec3(std::cos(yaw),-0.2f,std::sin(yaw));
+  const Vec3 r  = Vec3(-std::sin(yaw),0,std::cos(yaw));
+  const Vec3 u  = Vec3::crossProduct(r,d);
+  auto plane = [&](float* f, Vec3 n, float offset) {
+    n = n/n.length();
+    f[0] = n.x;
+    f[1] = n.y;
+    f[2] = n.z;
+    f[3] = -Vec3::dotProduct(n,at)+offset;
+    };
+
+  Frustrum fr;
+  plane(fr.f[0], d/d.length()+r, 0);
+  plane(fr.f[1], d/d.length()-r, 0);
+  plane(fr.f[2], d/d.length()+u/u.length(), 0);
+  plane(fr.f[3], d/d.length()-u/u.length(), 0);
+  plane(fr.f[4], d, -10.f);
+  plane(fr.f[5], Vec3()-d, zFar);
+  return fr;
+  }
+
+}
+
+bool lightBench() {
+  // LightGroup's dynamic bucket: animated vob lights first, effect lights allocated later;
+  // vob order in a zen is not spatial, so positions are shuffled over the world
+  const size_t   animated = 3072;
+  const size_t   count    = animated+1024;
+  const size_t   frames   = 600;
+  const uint64_t dt       = 16;
+  const float    spacing  = 250.f;
+
+  std::vector<Vec3> pos(count);
+  for(size_t i=0; i<count; ++i)
+    pos[i] = Vec3(float(i%64)*spacing,0,float(i/64)*spacing);
+  std::shuffle(pos.begin(),pos.end(),std::mt19937(3));
+
+  LightList list;
+  for(size_t i=0; i<count; ++i) {
+    const size_t id = list.alloc();
+    auto&        l  = list.light[id];
+    l.setPosition(pos[i]);
+    if(i<animated) {
+      l.setColor({Vec3(1,0.5f,0), Vec3(1,0.6f,0.1f), Vec3(0.9f,0.5f,0)},10,(i%2)==0);
+      l.setRange({1.f,1.1f,0.95f},500,8,(i%4)==0);
+      } else {
+      l.setColor(Vec3(1,1,1));
+      l.setRange(800);
+      }
+    l.setTimeOffset((i*37)%1000);
+    list.data[id].pos   = l.position();
+    list.data[id].range = l.range();
+    list.data[id].color = l.color();
+    }
+  std::vector<LightSource> light = list.light;
+
+  // before: every light updated and whole buffer re-uploaded each frame
+  std::vector<LightList::LightSsbo> full = list.data;
+  size_t     bytesFull = 0;
+  CheckTimer tFull;
+  for(size_t f=0; f<frames; ++f) {
+    for(size_t i=0; i<count; ++i) {
+      light[i].update(f*dt);
+      full[i].color = light[i].currentColor();
+      full[i].range = light[i].currentRange();
+      }
+    bytesFull += count*sizeof(LightList::LightSsbo);
+    }
+  const double msFull = tFull.ms();
+
+  // after: LightList::tick, only the changed range is uploaded
+  size_t     bytesDirty = 0;
+  CheckTimer tDirty;
+  for(size_t f=0; f<frames; ++f) {
+    size_t begin = 0, end = 0;
+    if(list.tick(f*dt,begin,end))
+      bytesDirty += (end-begin)*sizeof(LightList::LightSsbo);
+    }
+  const double msDirty = tDirty.ms();
+
+  // skipping static lights is only valid, if update() never changes them
+  for(size_t i=0; i<count; ++i) {
+    auto& a = full[i];
+    auto& b = list.data[i];
+    if(a.color!=b.color || a.range!=b.range) {
+      std::printf("  light %zu differs between full and dirty update\n",i);
+      return false;
+      }
+    }
+  std::printf("  %zu lights x %zu frames: full %.2f ms / %zu KiB, dirty %.2f ms / %zu KiB\n",
+              count,frames,msFull,bytesFull/1024,msDirty,bytesDirty/1024);
+
+  // culling: camera turns around inside the lit area
+  const Vec3  at   = Vec3(32.f*spacing,300.f,32.f*spacing);
+  const float zFar = 5000.f;
+
+  std::vector<uint32_t> ref, visible;
+  size_t drawnRange = 0, drawnList = 0;
+  double msRef = 0, msList = 0;
+  for(size_t f=0; f<frames; ++f) {
+    const Frustrum fr = view(at,float(f)*0.0105f,zFar);
+
+    // before: serial test, draw call covers [first,last] visible instance
+    {
+    CheckTimer t;
+    size_t begin = count, end = 0;
+    ref.clear();
+    for(size_t i=0; i<count; ++i) {
+      auto& l = list.data[i];
+      if(l.range<=0 || !fr.testPoint(l.pos,l.range))
+        continue;
+      ref.push_back(uint32_t(i));
+      begin = std::min(begin,i);
+      end   = i+1;
+      }
+    if(begin<end)
+      drawnRange += end-begin;
+    msRef += t.ms();
+    }
+
+    // after: LightList::cull on workers, compact index list
+    {
+    CheckTimer t;
+    list.cull(fr,visible);
+    drawnList += visible.size();
+    msList += t.ms();
+    }
+
+    if(visible!=ref) {
+      std::printf("  frame %zu: culled list differs from serial reference\n",f);
+      return false;
+      }
+    }
+
+  if(drawnList*2>drawnRange) {
+    std::printf("  compact list draws too many volumes: %zu of %zu\n",drawnList,drawnRange);
+    return false;
+    }
+  std::printf("  cull %zu frames: range %.2f ms / %.1f volumes, list %.2f ms / %.1f volumes\n",
+              frames,msRef,double(drawnRange)/double(frames),msList,double(drawnList)/double(frames));
+  return true;
+  }
@@ -0,0 +1,41 @@
+#include <cstring>
+#include <cstdio>
+
+#include "checks.h"
+
+static const Check checks[] = {
+  {"mem32_bench",         mem32Bench        },
+  {"pfx_bench",           pfxBench          },
+  {"light_bench",         lightBench        },
+  {"texture_cache",       textureCacheCheck },
+  {"dls_render",          dlsRender         },
+  {"mixer_simd",          mixerCheck        },
+  {"bvh_cache",           bvhCacheCheck     },
+  {"crowd_bench",         crowdBench        },
+  {"physics_determinism", physicsDeterminism},
+  {"step_list",           stepListCheck     },
+  {"workers_bench",       workersBench      },
+  };
+
+int main(int argc, const char** argv) {
+  const char* filter = argc>1 ? argv[1] : nullptr;
+
+  int  ret   = 0;
+  bool found = false;
+  for(auto& c:checks) {
+    if(filter!=nullptr && std::strcmp(filter,c.name)!=0)
+      continue;
+    found = true;
+    std::printf("[%s]\n",c.name);
+    if(!c.func()) {
+      std::printf("[%s] FAILED\n",c.name);
+      ret = 1;
+      }
+    }
+
+  if(!found) {
+    std::printf("unknown check: %s\n",filter);
+    return 1;
+    }
+  return ret;
+  }
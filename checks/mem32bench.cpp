@@ -0,0 +1,65 @@
+#include <vector>
+#include <random>
+
+#include "game/compatibility/mem32.h"
+#include "checks.h"
+
+bool mem32Bench() {
+  const size_t blocks = 4096;
+  const size_t reads  = 4'000'000;
+
+  Mem32                 mem;
+  std::vector<uint32_t> addr(blocks), size(blocks);
+  std::mt19937          rnd(1);
+
+  for(size_t i=0; i<blocks; ++i) {
+    size[i] = 8+uint32_t(rnd()%64)*8;
+    addr[i] = mem.alloc(size[i]);
+    if(addr[i]==0)
+      return false;
+    }
+
+  // punch holes, so translation runs over mixed free/allocated regions
+  for(size_t i=0; i<blocks; i+=3) {
+    mem.free(addr[i]);
+    addr[i] = mem.alloc(size[i]);
+    }
+
+  for(size_t i=0; i<blocks; ++i)
+    for(uint32_t off=0; off<size[i]; off+=4)
+      mem.writeInt(addr[i]+off,int32_t(addr[i]^off));
+
+  std::vector<uint32_t> query(reads);
+  std::vector<int32_t>  expect(reads);
+  for(size_t r=0; r<reads; ++r) {
+    size_t   i   = rnd()%blocks;
+    uint32_t off = (uint32_t(rnd())%(size[i]/4))*4;
+    query [r] = addr[i]+off;
+    expect[r] = int32_t(addr[i]^off);
+    }
+
+  CheckTimer tRandom;
+  size_t     bad = 0;
+  for(size_t r=0; r<reads; ++r) {
+    if(mem.readInt(query[r])!=expect[r])
+      ++bad;
+    }
+  const double msRandom = tRandom.ms();
+
+  // script style: many accesses to the same block in a row
+  CheckTimer tSeq;
+  for(size_t i=0; i<blocks; ++i) {
+    for(uint32_t off=0; off<size[i]; off+=4) {
+      if(mem.readInt(addr[i]+off)!=int32_t(addr[i]^off))
+        ++bad;
+      }
+    }
+  const double msSeq = tSeq.ms();
+
+  if(bad>0) {
+    std::printf("  %zu reads returned wrong data\n",bad);
+    return false;
+    }
+  std::printf("  %zu regions: %zu random reads %.2f ms, sequential scan %.2f ms\n",blocks,reads,msRandom,msSeq);
+  return true;
+  }
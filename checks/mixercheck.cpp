@@ -0,0 +1,133 @@
+#include <vector>
+#include <random>
+#include <limits>
+#include <cmath>
+
+#include "dmusic/mixersimd.h"
+#include "checks.h"
+
+using namespace Dx8;
+
+namespace {
+
+const char* simdPath() {
+#if defined(DX8_MIXER_SSE2)
+  return "sse2";
+#elif defined(DX8_MIXER_NEON)
+  return "neon";
+#else
+  return "scalar";
+#endif
+  }
+
+size_t mismatch(const std::vector<float>& a, const std::vector<float>& b, float eps) {
+  size_t ret = 0;
+  for(size_t i=0; i<a.size(); ++i) {
+    if(a[i]==b[i])
+      continue;
+    if(std::abs(a[i]-b[i])>eps*std::max(1.f,std::abs(b[i])))
+      ++ret;
+    }
+  return ret;
+  }
+
+}
+
+bool mixerCheck() {
+  // odd sizes: vector loops must hand over their tails correctly
+  const size_t frames = 1027, cnt = frames*2;
+
+  std::mt19937                          rnd(11);
+  std::uniform_real_distribution<float> pcm(-1.5f,1.5f);
+  std::uniform_real_distribution<float> unit(0.f,1.f);
+
+  bool ok     = true;
+  auto expect = [&ok](size_t bad, const char* what) {
+    if(bad>0) {
+      std::printf("  %s: %zu mismatches\n",what,bad);
+      ok = false;
+      }
+    };
+
+  std::vector<float> src(cnt), vol(frames), dst(cnt);
+  for(auto& i:src)
+    i = pcm(rnd);
+  for(auto& i:vol)
+    i = unit(rnd);
+  for(auto& i:dst)
+    i = pcm(rnd);
+
+  {
+  auto a = dst, b = dst;
+  MixerSimd::mixAccumulate(a.data(),src.data(),0.73f,cnt);
+  MixerSimd::Scalar::mixAccumulate(b.data(),src.data(),0.73f,cnt);
+  expect(mismatch(a,b,0.f),"accumulate");
+  }
+
+  {
+  auto a = dst, b = dst;
+  MixerSimd::mixAccumulate(a.data(),src.data(),0.73f,vol.data(),frames);
+  MixerSimd::Scalar::mixAccumulate(b.data(),src.data(),0.73f,vol.data(),frames);
+  expect(mismatch(a,b,0.f),"accumulate with curve");
+  }
+
+  {
+  // random mix plus values at, and next to, the clipping thresholds
+  std::vector<float> in = src;
+  const float inf = std::numeric_limits<float>::infinity();
+  for(float e:{1.00001514f, -1.00004566f, 1.f, -1.f, 1e30f, -1e30f, inf, -inf, 0.f}) {
+    in.push_back(e);
+    in.push_back(std::nextafter(e, inf));
+    in.push_back(std::nextafter(e,-inf));
+    }
+  for(float vm:{1.f, 0.8f, 2.5f}) {
+    std::vector<int16_t> a(in.size()), b(in.size());
+    MixerSimd::toInt16(a.data(),in.data(),vm,in.size());
+    MixerSimd::Scalar::toInt16(b.data(),in.data(),vm,in.size());
+    size_t bad = 0;
+    for(size_t i=0; i<in.size(); ++i)
+      if(a[i]!=b[i])
+        ++bad;
+    expect(bad,"int16 conversion");
+    }
+  }
+
+  {
+  // neon ramp multiplies by reciprocal: allow float rounding there
+  const float eps = 1e-6f;
+  for(size_t begin:{size_t(0), size_t(3), size_t(17)}) {
+    const float s = float(begin)-5.f, range = 977.f;
+    std::vector<float> a(frames,-1.f), b(frames,-1.f);
+    MixerSimd::curveRamp(a.data(),begin,frames,s,range);
+    MixerSimd::Scalar::curveRamp(b.data(),begin,frames,s,range);
+    expect(mismatch(a,b,eps),"curve ramp");
+
+    MixerSimd::curveScale(a.data(),begin,frames,-0.6f,0.9f);
+    MixerSimd::Scalar::curveScale(b.data(),begin,frames,-0.6f,0.9f);
+    expect(mismatch(a,b,eps),"curve scale");
+    }
+  }
+
+  // timing of the full mix step, as Mixer::implMix runs it per instrument
+  const size_t rounds = 20000;
+  std::vector<int16_t> out(cnt);
+  double msSimd = 0, msScalar = 0;
+  {
+  CheckTimer t;
+  for(size_t r=0; r<rounds; ++r) {
+    MixerSimd::mixAccumulate(dst.data(),src.data(),1e-6f,vol.data(),frames);
+    MixerSimd::toInt16(out.data(),dst.data(),0.5f,cnt);
+    }
+  msSimd = t.ms();
+  }
+  {
+  CheckTimer t;
+  for(size_t r=0; r<rounds; ++r) {
+    MixerSimd::Scalar::mixAccumulate(dst.data(),src.data(),1e-6f,vol.data(),frames);
+    MixerSimd::Scalar::toInt16(out.data(),dst.data(),0.5f,cnt);
+    }
+  msScalar = t.ms();
+  }
+  std::printf("  %s: %zu frames x %zu, vector %.2f ms, scalar %.2f ms\n",simdPath(),frames,rounds,msSimd,msScalar);
+  return ok;
+  }
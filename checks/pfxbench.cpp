@@ -0,0 +1,170 @@
+#include <vector>
+#include <cstring>
+
+#include "graphics/pfx/pfxparticles.h"
+#include "checks.h"
+
+using namespace Tempest;
+
+namespace {
+
+// particle layout before the SoA split, as reference
+struct ParState final {
+  uint16_t life=0, maxLife=1;
+  Vec3     pos, dir;
+  std::vector<PfxParticles::Trail> trail;
+  };
+
+bool sameBits(float a, float b) {
+  return std::memcmp(&a,&b,sizeof(float))==0;
+  }
+
+bool sameBits(const PfxParticles::State& a, const PfxParticles::State& b) {
+  return std::memcmp(&a,&b,sizeof(a))==0;
+  }
+
+// per-particle billboard, as PfxBucket built it before
+void buildBilboard(PfxParticles::State& v, const ParState& p, const PfxParticles::Visual& vis) {
+  if(p.life==0) {
+    v.size = Vec3();
+    return;
+    }
+  const float a     = 1.f-float(p.life)/float(p.maxLife);
+  const Vec3  cl    = vis.colorS*(1.f-a) + vis.colorE*a;
+  const float clA   = vis.alphaS*(1.f-a) + vis.alphaE*a;
+  const float scale = 1.f*(1.f-a) + a*vis.sizeEndScale;
+  const float szX   = vis.sizeX*scale;
+  const float szY   = vis.sizeY*scale;
+  const float szZ   = 0.1f*((szX+szY)*0.5f);
+
+  uint8_t color[4] = {255,255,255,255};
+  if(vis.additive) {
+    color[0] = uint8_t(cl.x*clA);
+    color[1] = uint8_t(cl.y*clA);
+    color[2] = uint8_t(cl.z*clA);
+    } else {
+    color[0] = uint8_t(cl.x);
+    color[1] = uint8_t(cl.y);
+    color[2] = uint8_t(cl.z);
+    color[3] = uint8_t(clA*255);
+    }
+  std::memcpy(&v.color,color,4);
+  v.pos   = p.pos + vis.origin;
+  v.size  = Vec3(szX,szY,szZ);
+  v.bits0 = vis.bits0;
+  v.dir   = p.dir;
+  }
+
+}
+
+bool pfxBench() {
+  const size_t   count   = 1 << 18;
+  const size_t   steps   = 100;
+  const uint64_t dt      = 16;
+  const float    dtF     = float(dt);
+  const Vec3     gravity = Vec3(0,-0.0002f,0);
+
+  std::vector<ParState> aos(count);
+  PfxParticles          soa;
+  soa.resize(count);
+
+  for(size_t i=0; i<count; ++i) {
+    auto&          p = aos[i];
+    const uint64_t r = i*6;
+    p.life    = (i%7==0) ? 0 : 60000;
+    p.maxLife = 60000;
+    p.pos     = Vec3(PfxParticles::rand(1,r+0),PfxParticles::rand(1,r+1),PfxParticles::rand(1,r+2));
+    p.dir     = Vec3(PfxParticles::rand(1,r+3),PfxParticles::rand(1,r+4),PfxParticles::rand(1,r+5));
+    if(p.life==0) {
+      p.pos = Vec3();
+      p.dir = Vec3();
+      }
+    soa.life   [i] = p.life;
+    soa.maxLife[i] = p.maxLife;
+    soa.setPos(i,p.pos);
+    soa.setDir(i,p.dir);
+    }
+
+  CheckTimer tAos;
+  for(size_t s=0; s<steps; ++s) {
+    for(auto& p:aos) {
+      if(p.life==0)
+        continue;
+      p.pos += p.dir*dtF;
+      p.dir += gravity*dtF;
+      }
+    }
+  const double msAos = tAos.ms();
+
+  CheckTimer tSoa;
+  for(size_t s=0; s<steps; ++s)
+    soa.integrate(0,count,gravity,dtF);
+  const double msSoa = tSoa.ms();
+
+  for(size_t i=0; i<count; ++i) {
+    auto& p = aos[i];
+    auto  a = soa.pos(i);
+    auto  b = soa.dir(i);
+    if(!sameBits(p.pos.x,a.x) || !sameBits(p.pos.y,a.y) || !sameBits(p.pos.z,a.z) ||
+       !sameBits(p.dir.x,b.x) || !sameBits(p.dir.y,b.y) || !sameBits(p.dir.z,b.z)) {
+      std::printf("  particle %zu differs from AoS reference\n",i);
+      return false;
+      }
+    }
+
+  // billboards: per-particle AoS build against the SoA pass used by PfxBucket::buildSsbo
+  PfxParticles::Visual vis;
+  vis.colorS       = Vec3(255,200,90);
+  vis.colorE       = Vec3(40,10,0);
+  vis.alphaS       = 1.f;
+  vis.alphaE       = 0.f;
+  vis.sizeX        = 12.f;
+  vis.sizeY        = 8.f;
+  vis.sizeEndScale = 3.f;
+  vis.bits0        = 0x15;
+  vis.origin       = Vec3(100,-20,3);
+
+  const size_t builds = 20;
+  double       msBbAos = 0, msBbSoa = 0;
+  for(int additive=0; additive<2; ++additive) {
+    vis.additive = additive!=0;
+    std::vector<PfxParticles::State> outAos(count), outSoa(count);
+
+    CheckTimer tBbAos;
+    for(size_t s=0; s<builds; ++s)
+      for(size_t i=0; i<count; ++i)
+        buildBilboard(outAos[i],aos[i],vis);
+    msBbAos += tBbAos.ms();
+
+    CheckTimer tBbSoa;
+    for(size_t s=0; s<builds; ++s)
+      soa.buildBilboards(outSoa.data(),0,count,vis);
+    msBbSoa += tBbSoa.ms();
+
+    for(size_t i=0; i<count; ++i) {
+      auto& sz   = outSoa[i].size;
+      bool  same = aos[i].life==0 ? (sz.x==0 && sz.y==0 && sz.z==0) : sameBits(outAos[i],outSoa[i]);
+      if(!same) {
+        std::printf("  billboard %zu differs from AoS reference\n",i);
+        return false;
+        }
+      }
+    }
+
+  // same (seed,counter) yields same value; neighbour seeds yield different streams
+  size_t equal = 0;
+  for(uint64_t i=0; i<1024; ++i) {
+    if(PfxParticles::rand(7,i)!=PfxParticles::rand(7,i))
+      return false;
+    if(PfxParticles::rand(7,i)==PfxParticles::rand(8,i))
+      ++equal;
+    }
+  if(equal>16) {
+    std::printf("  seeds 7 and 8 are correlated: %zu of 1024 equal\n",equal);
+    return false;
+    }
+
+  std::printf("  %zu particles x %zu steps: AoS %.2f ms, SoA %.2f ms\n",count,steps,msAos,msSoa);
+  std::printf("  %zu particles x %zu billboard builds: AoS %.2f ms, SoA %.2f ms\n",count,2*builds,msBbAos,msBbSoa);
+  return true;
+  }
@@ -0,0 +1,204 @@
+#include <Tempest/Matrix4x4>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <cmath>
+
+#include "physics/collisionworld.h"
+#include "utils/fnvhash.h"
+#include "utils/workers.h"
+#include "checks.h"
+
+namespace {
+
+// bodies overlap in xz, so piles and contact islands form on the way down
+struct Scene final {
+  enum { Count = 400 };
+
+  Scene():ground(btVector3(50,1,50)), box(btVector3(0.15f,0.1f,0.2f)), ball(0.15f) {}
+
+  static Tempest::Matrix4x4 floorAt() {
+    Tempest::Matrix4x4 mt;
+    mt.identity();
+    mt.translate(0,-100,0);
+    return mt;
+    }
+
+  static Tempest::Matrix4x4 bodyAt(int i) {
+    Tempest::Matrix4x4 at;
+    at.identity();
+    at.translate(float(i%10)*22.f - 100.f, 50.f+float(i/10)*40.f, float((i*7)%10)*22.f - 100.f);
+    return at;
+    }
+
+  btCollisionShape& shape(int i) { return (i%3==0) ? static_cast<btCollisionShape&>(ball) : box; }
+  static float      mass (int i) { return 1.f+float(i%4); }
+
+  btBoxShape    ground;
+  btBoxShape    box;
+  btSphereShape ball;
+  };
+
+// hash of all body transforms
+uint64_t hashBodies(uint64_t h, const std::vector<btRigidBody*>& body) {
+  for(auto b:body) {
+    // w-components are padding, hash x,y,z only
+    auto& tr = b->getWorldTransform();
+    for(int r=0; r<3; ++r) {
+      h = FnvHash::bytes(h,&tr.getOrigin()[r],sizeof(btScalar));
+      h = FnvHash::bytes(h,&tr.getBasis()[r][0],3*sizeof(btScalar));
+      }
+    }
+  return h;
+  }
+
+struct Pile final {
+  Pile() {
+    world.reset(new CollisionWorld());
+    floor = world->addCollisionBody(scene.ground,Scene::floorAt(),0.8f);
+    for(int i=0; i<Scene::Count; ++i) {
+      body.push_back(world->addDynamicBody(scene.shape(i),Scene::bodyAt(i),0.6f,Scene::mass(i)));
+      ptr.push_back(body.back().get());
+      }
+    }
+
+  uint64_t run(size_t frames, double& ms) {
+    uint64_t   h = FnvHash::basis;
+    CheckTimer t;
+    for(size_t f=0; f<frames; ++f) {
+      // game moves item bodies through callbacks, that refresh their aabbs
+      world->touchAabbs();
+      world->tick(16);
+      h = hashBodies(h,ptr);
+      }
+    ms = t.ms();
+    return h;
+    }
+
+  // destroyed in reverse: bodies before world, world before shapes
+  Scene                                                     scene;
+  std::unique_ptr<CollisionWorld>                           world;
+  std::unique_ptr<CollisionWorld::CollisionBody>            floor;
+  std::vector<std::unique_ptr<CollisionWorld::DynamicBody>> body;
+  std::vector<btRigidBody*>                                 ptr;
+  };
+
+// same scene in plain single-threaded bullet, set up as CollisionWorld does it
+struct SerialPile final {
+  explicit SerialPile(const btVector3& gravity)
+    :disp(&conf), world(&disp,&broad,&solver,&conf) {
+    world.setForceUpdateAllAabbs(false);
+    world.setGravity(gravity);
+
+    auto tr = [](const Tempest::Matrix4x4& m) {
+      btTransform t;
+      t.setFromOpenGLMatrix(m.data());
+      t.getOrigin()*=0.01f;
+      return t;
+      };
+
+    btRigidBody::btRigidBodyConstructionInfo floorCI(0,nullptr,&scene.ground,btVector3(0,0,0));
+    floor.reset(new btRigidBody(floorCI));
+    floor->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
+    floor->setWorldTransform(tr(Scene::floorAt()));
+    floor->setFriction(0.8f);
+    world.addCollisionObject(floor.get());
+
+    for(int i=0; i<Scene::Count; ++i) {
+      btVector3 inertia = {};
+      scene.shape(i).calculateLocalInertia(Scene::mass(i),inertia);
+      btRigidBody::btRigidBodyConstructionInfo ci(Scene::mass(i),nullptr,&scene.shape(i),inertia);
+      std::unique_ptr<btRigidBody> b(new btRigidBody(ci));
+      b->setWorldTransform(tr(Scene::bodyAt(i)));
+      b->setFriction(0.6f);
+      b->setActivationState(ACTIVE_TAG);
+      b->setCcdSweptSphereRadius(0.1f);
+      b->setCcdMotionThreshold(0.005f);
+      world.addRigidBody(b.get());
+      ptr.push_back(b.get());
+      body.push_back(std::move(b));
+      }
+    }
+
+  ~SerialPile() {
+    for(auto& b:body)
+      world.removeRigidBody(b.get());
+    world.removeCollisionObject(floor.get());
+    }
+
+  void run(size_t frames) {
+    for(size_t f=0; f<frames; ++f)
+      world.stepSimulation(16.f/1000.f,2);
+    }
+
+  Scene                                     scene;
+  btDefaultCollisionConfiguration           conf;
+  btCollisionDispatcher                     disp;
+  btDbvtBroadphase                          broad;
+  btSequentialImpulseConstraintSolver       solver;
+  btDiscreteDynamicsWorld                   world;
+  std::unique_ptr<btRigidBody>              floor;
+  std::vector<std::unique_ptr<btRigidBody>> body;
+  std::vector<btRigidBody*>                 ptr;
+  };
+
+}
+
+bool physicsDeterminism() {
+  const size_t frames = 180;
+  const size_t runs   = 2;
+
+  // task count changes how loops are split, but must not change the result
+  std::vector<size_t> threads = {1, 2, size_t(Workers::maxThreads())};
+  threads.erase(std::unique(threads.begin(),threads.end()),threads.end());
+
+  uint64_t ref   = 0;
+  bool     first = true, ok = true;
+  for(size_t th:threads) {
+    CollisionWorld::setTaskLimit(th);
+    for(size_t i=0; i<runs; ++i) {
+      double   ms = 0;
+      Pile     pile;
+      uint64_t h  = pile.run(frames,ms);
+      std::printf("  %zu tasks, run %zu: %zu bodies, %zu ticks, %.2f ms, state %016llx\n",
+                  th,i,size_t(Scene::Count),frames,ms,static_cast<unsigned long long>(h));
+      if(first)
+        ref = h;
+      first = false;
+      if(h!=ref)
+        ok = false;
+      }
+    }
+  CollisionWorld::setTaskLimit(0);
+  if(!ok)
+    std::printf("  simulation diverges between runs or task counts\n");
+
+  // serial bullet orders contacts differently (island sort), so the pile can't match bit for bit;
+  // it still must land in the same place, not tunnel or explode
+  double ms = 0;
+  Pile   pile;
+  pile.run(frames,ms);
+  SerialPile serial(pile.world->getGravity());
+  serial.run(frames);
+
+  float  maxDist = 0, sumDist = 0;
+  size_t fallen  = 0;
+  for(size_t i=0; i<pile.ptr.size(); ++i) {
+    const btVector3& a = pile  .ptr[i]->getWorldTransform().getOrigin();
+    const btVector3& b = serial.ptr[i]->getWorldTransform().getOrigin();
+    const float      d = a.distance(b);
+    maxDist  = std::max(maxDist,d);
+    sumDist += d;
+    if(a.y()<-0.5f || b.y()<-0.5f)
+      ++fallen;
+    }
+  const float meanDist = sumDist/float(pile.ptr.size());
+  std::printf("  vs serial btDiscreteDynamicsWorld: mean %.3f m, max %.3f m, %zu bodies under floor\n",
+              double(meanDist),double(maxDist),fallen);
+  if(fallen>0 || meanDist>0.5f) {
+    std::printf("  parallel world doesn't match serial reference\n");
+    ok = false;
+    }
+  return ok;
+  }
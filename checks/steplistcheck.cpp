@@ -0,0 +1,88 @@
+#include <vector>
+#include <atomic>
+
+#include "physics/steplist.h"
+#include "checks.h"
+
+namespace {
+
+struct Obj final {
+  explicit Obj(int id):id(id) {}
+  int id      = 0;
+  int applied = 0;
+  };
+
+struct Step final {
+  Obj* body  = nullptr;
+  int  query = -1;
+  };
+
+}
+
+bool stepListCheck() {
+  bool ok     = true;
+  auto expect = [&ok](bool v, const char* what) {
+    if(!v) {
+      std::printf("  %s\n",what);
+      ok = false;
+      }
+    };
+
+  StepList<Obj,Step> list;
+  std::vector<Obj*>  obj;
+  for(int i=0; i<64; ++i)
+    obj.push_back(list.add(i));
+
+  // first tick: every 4th object deletes its successor in list order, every 8th deletes itself,
+  // every 16th spawns a new one
+  std::atomic<size_t> queried{0};
+  std::vector<int>    order, spawned;
+  list.tick([&](Step& s) {
+    s.query = s.body->id;
+    queried.fetch_add(1);
+    },
+    [&](Step& s) {
+    expect(s.query==s.body->id, "query result belongs to another object");
+    const int id = s.body->id;
+    order.push_back(id);
+    s.body->applied++;
+    if(id<64 && id%4==0 && id>0)
+      list.del(obj[size_t(id-1)]);
+    if(id<64 && id%16==0)
+      spawned.push_back(list.add(100+id)->id);
+    if(id<64 && id%8==7)
+      list.del(s.body);
+    });
+
+  expect(queried.load()==64, "query must run for every object");
+  // list order is reverse of insertion: 63..0; successor of 'id' in that order is 'id-1'
+  bool inOrder = true;
+  for(size_t i=1; i<order.size(); ++i)
+    inOrder &= order[i]<order[i-1];
+  expect(inOrder, "apply must run in list order");
+  for(int id:order) {
+    expect(id<64,                   "object, spawned during apply, must wait for next tick");
+    expect(!(id%4==3 && id<63),     "object, deleted during apply, must be skipped");
+    }
+
+  // deleted: successors of every 4th (3,7,...,59) and every 8th (7,15,...,63) from itself
+  size_t expectSize = 64+spawned.size();
+  for(int id=0; id<64; ++id)
+    if((id%4==3 && id<63) || id%8==7)
+      --expectSize;
+  expect(list.size()==expectSize, "unexpected object count after deletes");
+
+  // second tick: spawned objects move as well
+  size_t newApplied = 0;
+  list.tick([](Step& s) {
+    s.query = s.body->id;
+    },
+    [&](Step& s) {
+    if(s.body->id>=100)
+      ++newApplied;
+    });
+  expect(newApplied==spawned.size(), "spawned objects must be stepped on next tick");
+
+  std::printf("  %zu objects applied, %zu spawned, %zu left\n",order.size(),spawned.size(),list.size());
+  return ok;
+  }
@@ -0,0 +1,91 @@
+#include <filesystem>
+#include <cstring>
+
+#include "utils/texturediskcache.h"
+#include "checks.h"
+
+using namespace Tempest;
+
+static bool samePixels(const Pixmap& a, const Pixmap& b) {
+  if(a.w()!=b.w() || a.h()!=b.h() || a.format()!=b.format())
+    return false;
+  return std::memcmp(a.data(),b.data(),size_t(a.w())*size_t(a.h())*4)==0;
+  }
+
+bool textureCacheCheck() {
+  auto dir = std::filesystem::temp_directory_path()/"opengothic-checks-tex";
+  std::error_code ec;
+  std::filesystem::remove_all(dir,ec);
+
+  Pixmap pm(17,9,TextureFormat::RGBA8);
+  auto*  px = reinterpret_cast<uint8_t*>(pm.data());
+  for(size_t i=0; i<size_t(pm.w())*size_t(pm.h())*4; ++i)
+    px[i] = uint8_t(i*31+7);
+
+  const size_t srcSize = 1234;
+  bool         ok      = true;
+  auto expect = [&ok](bool v, const char* what) {
+    if(!v) {
+      std::printf("  %s\n",what);
+      ok = false;
+      }
+    };
+
+  {
+  TextureDiskCache cache(dir.u16string(),42);
+  Pixmap           out;
+  expect(!cache.load("WALL-C.TEX",srcSize,out),        "miss on empty cache");
+  expect(cache.store("WALL-C.TEX",srcSize,pm),         "store");
+  expect(cache.load("WALL-C.TEX",srcSize,out),         "load after store");
+  expect(samePixels(pm,out),                           "round-trip pixels");
+  expect(cache.load("wall-c.tex",srcSize,out),         "case-insensitive name");
+  expect(!cache.load("WALL-C.TEX",srcSize+1,out),      "source size mismatch");
+  expect(!cache.store("HDR-C.TEX",srcSize,Pixmap(4,4,TextureFormat::RGBA16)), "hdr formats are not cacheable");
+  }
+
+  {
+  // archives changed
+  TextureDiskCache cache(dir.u16string(),43);
+  Pixmap           out;
+  expect(!cache.load("WALL-C.TEX",srcSize,out),        "stamp mismatch");
+  }
+
+  {
+  // corrupt payload: entry is rejected and removed
+  for(auto& f:std::filesystem::directory_iterator(dir)) {
+    auto sz = std::filesystem::file_size(f.path());
+    std::FILE* fp = std::fopen(f.path().string().c_str(),"r+b");
+    if(fp==nullptr)
+      continue;
+    std::fseek(fp,long(sz-1),SEEK_SET);
+    std::fputc(0x5A,fp);
+    std::fclose(fp);
+    }
+  TextureDiskCache cache(dir.u16string(),42);
+  Pixmap           out;
+  expect(!cache.load("WALL-C.TEX",srcSize,out),        "corrupted entry");
+  expect(std::filesystem::is_empty(dir),               "corrupted entry removed");
+  }
+
+  {
+  // forged payload size: rejected by file size, before anything is allocated
+  TextureDiskCache cache(dir.u16string(),42);
+  Pixmap           out;
+  expect(cache.store("WALL-C.TEX",srcSize,pm),         "store after corruption");
+  for(auto& f:std::filesystem::directory_iterator(dir)) {
+    std::FILE* fp = std::fopen(f.path().string().c_str(),"r+b");
+    if(fp==nullptr)
+      continue;
+    // Header: magic, version, key, metaSize, dataSize
+    const uint64_t size = uint64_t(1) << 40;
+    std::fseek(fp,24,SEEK_SET);
+    std::fwrite(&size,sizeof(size),1,fp);
+    std::fclose(fp);
+    }
+  expect(!cache.load("WALL-C.TEX",srcSize,out),        "oversized entry");
+  expect(std::filesystem::is_empty(dir),               "oversized entry removed");
+  }
+
+  std::filesystem::remove_all(dir,ec);
+  return ok;
+  }
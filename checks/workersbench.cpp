@@ -0,0 +1,287 @@
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/workers.h"
+#include "checks.h"
+
+namespace {
+
+// Fork-join pool, as Workers used to be: one global job at a time, threads woken through a condition variable,
+// static split into one chunk per thread, no nesting
+class ForkJoinPool final {
+  public:
+    explicit ForkJoinPool(size_t count) {
+      for(size_t i=0; i<count; ++i)
+        th.emplace_back([this](){ threadFunc(); });
+      }
+
+    ~ForkJoinPool() {
+      {
+      std::lock_guard<std::mutex> guard(sync);
+      stop = true;
+      }
+      start.notify_all();
+      for(auto& i:th)
+        i.join();
+      }
+
+    size_t threads() const { return th.size()+1; }
+
+    void forkJoin(size_t count, const std::function<void(size_t)>& fn) {
+      {
+      std::unique_lock<std::mutex> lck(sync);
+      // late threads of previous call may still hold its job
+      idle.wait(lck,[this](){ return active==0; });
+      func  = &fn;
+      total = count;
+      next.store(0);
+      left.store(count);
+      ++gen;
+      }
+      start.notify_all();
+      drain(&fn,count);
+      while(left.load()>0)
+        std::this_thread::yield();
+      }
+
+    template<class F>
+    void parallelFor(size_t size, const F& fn) {
+      const size_t tasks = std::min(threads(),size);
+      const size_t batch = (size+tasks-1)/tasks;
+      forkJoin(tasks,[&](size_t id) {
+        const size_t b = std::min(id*batch,size);
+        const size_t e = std::min(b+batch,size);
+        for(size_t i=b; i<e; ++i)
+          fn(i);
+        });
+      }
+
+  private:
+    void threadFunc() {
+      uint64_t                     seen = 0;
+      std::unique_lock<std::mutex> lck(sync);
+      while(true) {
+        start.wait(lck,[&](){ return gen!=seen || stop; });
+        if(stop)
+          return;
+        seen = gen;
+        auto fn = func;
+        auto n  = total;
+        ++active;
+        lck.unlock();
+        drain(fn,n);
+        lck.lock();
+        if(--active==0)
+          idle.notify_all();
+        }
+      }
+
+    void drain(const std::function<void(size_t)>* fn, size_t n) {
+      while(true) {
+        const size_t i = next.fetch_add(1);
+        if(i>=n)
+          return;
+        (*fn)(i);
+        left.fetch_sub(1);
+        }
+      }
+
+    std::vector<std::thread>            th;
+    std::mutex                          sync;
+    std::condition_variable             start, idle;
+    uint64_t                            gen    = 0;
+    size_t                              active = 0;
+    bool                                stop   = false;
+    const std::function<void(size_t)>*  func   = nullptr;
+    size_t                              total  = 0;
+    std::atomic<size_t>                 next{0};
+    std::atomic<size_t>                 left{0};
+  };
+
+uint32_t work(size_t i, size_t iters) {
+  uint32_t h = uint32_t(i)*2654435761u;
+  for(size_t r=0; r<iters; ++r)
+    h = (h ^ (h>>15))*2246822519u + uint32_t(r);
+  return h;
+  }
+
+void report(const char* name, double pool, double wrk) {
+  std::printf("  %-8s fork-join %8.2f ms, workers %8.2f ms (%.2fx)\n",name,pool,wrk,pool/std::max(wrk,1e-3));
+  }
+
+}
+
+bool workersBench() {
+  ForkJoinPool pool(std::max<size_t>(1,Workers::maxThreads()-1u));
+  bool         ok = true;
+
+  std::vector<uint32_t> ref, outP, outW;
+  auto check = [&](const char* name, const std::vector<uint32_t>& out) {
+    if(out!=ref) {
+      std::printf("  %s: wrong result\n",name);
+      ok = false;
+      }
+    };
+
+  // uniform: many short parallel loops, as in per-frame animation/culling; dominated by dispatch cost
+  {
+  const size_t calls = 2000, size = 4096, iters = 16;
+  ref.resize(size);
+  for(size_t i=0; i<size; ++i)
+    ref[i] = work(i,iters);
+  outP.assign(size,0);
+  outW.assign(size,0);
+
+  CheckTimer tp;
+  for(size_t c=0; c<calls; ++c)
+    pool.parallelFor(size,[&](size_t i){ outP[i] = work(i,iters); });
+  const double p = tp.ms();
+
+  CheckTimer tw;
+  for(size_t c=0; c<calls; ++c)
+    Workers::parallelFor(outW,[&](uint32_t& v){ v = work(size_t(&v-outW.data()),iters); });
+  const double w = tw.ms();
+
+  check("uniform/fork-join",outP);
+  check("uniform/workers",  outW);
+  report("uniform",p,w);
+  }
+
+  // skewed: per-item cost varies a lot; static chunks leave threads idle, stealing balances them
+  {
+  const size_t calls = 40, size = 2048;
+  auto iters = [](size_t i) { return (i%64)==0 ? size_t(20000) : size_t(200); };
+  ref.resize(size);
+  for(size_t i=0; i<size; ++i)
+    ref[i] = work(i,iters(i));
+  outP.assign(size,0);
+  outW.assign(size,0);
+
+  CheckTimer tp;
+  for(size_t c=0; c<calls; ++c)
+    pool.parallelFor(size,[&](size_t i){ outP[i] = work(i,iters(i)); });
+  const double p = tp.ms();
+
+  CheckTimer tw;
+  for(size_t c=0; c<calls; ++c)
+    Workers::parallelTasks(outW,[&](uint32_t& v){ size_t i = size_t(&v-outW.data()); v = work(i,iters(i)); });
+  const double w = tw.ms();
+
+  check("skewed/fork-join",outP);
+  check("skewed/workers",  outW);
+  report("skewed",p,w);
+  }
+
+  // nested: outer loop over objects, inner loop over their parts; fork-join pool has to run inner loops inline
+  {
+  const size_t calls = 100, outer = 16, inner = 1024, iters = 32;
+  const size_t size  = outer*inner;
+  ref.resize(size);
+  for(size_t i=0; i<size; ++i)
+    ref[i] = work(i,iters);
+  outP.assign(size,0);
+  outW.assign(size,0);
+
+  CheckTimer tp;
+  for(size_t c=0; c<calls; ++c)
+    pool.parallelFor(outer,[&](size_t o) {
+      for(size_t i=0; i<inner; ++i)
+        outP[o*inner+i] = work(o*inner+i,iters);
+      });
+  const double p = tp.ms();
+
+  CheckTimer tw;
+  for(size_t c=0; c<calls; ++c)
+    Workers::parallelTasks(outer,[&](uintptr_t o) {
+      Workers::parallelFor(outW.data()+o*inner,outW.data()+(o+1)*inner,[&](uint32_t& v) {
+        v = work(size_t(&v-outW.data()),iters);
+        });
+      });
+  const double w = tw.ms();
+
+  check("nested/fork-join",outP);
+  check("nested/workers",  outW);
+  report("nested",p,w);
+  }
+
+  // graph: three dependent stages per frame; fork-join needs a full barrier between stages,
+  // tasks start as soon as their own inputs are ready
+  {
+  const size_t frames = 500, width = 32, iters = 2000;
+  std::vector<uint32_t> a(width), b(width), c(1);
+  auto stageA = [&](size_t i) { a[i] = work(i,iters); };
+  auto stageB = [&](size_t i) { b[i] = work(a[i]^a[(i+1)%width],iters); };
+  auto stageC = [&]()         { uint32_t s = 0; for(auto v:b) s ^= v; c[0] = s; };
+  // results of previous frame must not hide a task, that ran before its inputs
+  auto reset  = [&]()         { std::fill(a.begin(),a.end(),0); std::fill(b.begin(),b.end(),0); c[0] = 0; };
+
+  for(size_t i=0; i<width; ++i)
+    stageA(i);
+  for(size_t i=0; i<width; ++i)
+    stageB(i);
+  stageC();
+  ref = c;
+
+  CheckTimer tp;
+  for(size_t f=0; f<frames; ++f) {
+    reset();
+    pool.forkJoin(width,stageA);
+    pool.forkJoin(width,stageB);
+    stageC();
+    }
+  const double p = tp.ms();
+  check("graph/fork-join",c);
+
+  CheckTimer tw;
+  for(size_t f=0; f<frames; ++f) {
+    reset();
+    std::vector<Workers::Task> ta(width), tb(width);
+    for(size_t i=0; i<width; ++i)
+      ta[i] = Workers::spawn([&stageA,i](){ stageA(i); });
+    for(size_t i=0; i<width; ++i)
+      tb[i] = Workers::spawn([&stageB,i](){ stageB(i); },{ta[i],ta[(i+1)%width]});
+    Workers::wait(Workers::spawn(stageC,tb));
+    }
+  const double w = tw.ms();
+  check("graph/workers",c);
+  report("graph",p,w);
+  }
+
+  // long background tasks must not be picked up by a thread, that only joins its own parallel loop
+  {
+  const auto                 mainId = std::this_thread::get_id();
+  std::atomic<bool>          inJoin{false};
+  std::atomic<size_t>        stolen{0};
+  std::vector<Workers::Task> loads;
+  for(size_t i=0; i<Workers::maxThreads()*2u; ++i)
+    loads.push_back(Workers::spawn([&]() {
+      if(inJoin.load() && std::this_thread::get_id()==mainId)
+        stolen.fetch_add(1);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }));
+
+  std::vector<uint32_t> data(4096);
+  inJoin.store(true);
+  for(size_t c=0; c<200; ++c)
+    Workers::parallelTasks(8,[&](uintptr_t id) {
+      for(size_t i=id; i<data.size(); i+=8)
+        data[i] = work(i,16);
+      });
+  inJoin.store(false);
+  for(auto& i:loads)
+    Workers::wait(i);
+  if(stolen.load()>0) {
+    std::printf("  parallel loop ran %zu unrelated tasks on the calling thread\n",stolen.load());
+    ok = false;
+    }
+  }
+
+  std::printf("  %zu threads\n",pool.threads());
+  return ok;
+  }
@@ -52,10 +52,15 @@ void Camera::reset(const Npc* pl) {
   dst.spin.y   = pl ? pl->rotation() : 0;
 
   src.spin     = dst.spin;
+  colCache     = ColisionCache();
 
   calcControlPoints(-1.f);
   }
 
+void Camera::onWorldChanged() {
+  colCache = ColisionCache();
+  }
+
 void Camera::save(Serialize &s) {
   s.write(src.range, src.target, src.spin,
           dst.range, dst.target, dst.spin);
@@ -719,17 +724,66 @@ float Camera::calcCameraColision(const Vec3& target, const Vec3& origin, const V
   float minDist = 20;
   float padding = 20;
 
+  // reuse probes from last frame, if neither target nor camera did move noticeably
+  // age limit is to pick up movers (doors, lifts) eventually
+  static const float   moveEps = 0.5f, spinEps = 0.05f, fastMove = 20.f, jump = 500.f;
+  static const uint8_t maxAge  = 8;
+  auto& c = colCache;
+  if(c.valid && (c.target-target).quadLength()>jump*jump) {
+    // teleport or target switch: old probe says nothing about new place, and it's not a fast camera either
+    c = ColisionCache();
+    }
+  if(c.valid && c.dist==dist && c.age<maxAge &&
+     (c.target-target).quadLength()<moveEps*moveEps &&
+     (c.origin-origin).quadLength()<moveEps*moveEps &&
+     std::abs(c.spin.x-rotSpin.x)<spinEps && std::abs(c.spin.y-rotSpin.y)<spinEps) {
+    raysCasted = 0;
+    raysReused = true;
+    c.age++;
+    return c.result;
+    }
+
   auto& physic = *world->physic();
   Matrix4x4 vinv=projective();
   vinv.mul(mkView(origin,rotSpin));
   vinv.inverse();
 
   raysCasted = 0;
+  raysReused = false;
   float distMd = dist;
   auto  tr     = origin - target;
+
+  // one sphere sweep over near-plane extent covers all of the rays below
+  Vec3 nc = {0,0,0}, n1 = {1,1,0};
+  vinv.project(nc.x,nc.y,nc.z);
+  vinv.project(n1.x,n1.y,n1.z);
+  raysCasted++;
+  auto sweep = physic.sweepSphere(target,nc,(n1-nc).length());
+  if(sweep.hasCol) {
+    // fast camera: corner and center rays only; full set, if probe starts inside of geometry
+    const bool fast = c.valid && sweep.hitFraction>0.f &&
+                      (c.target-target).length()+(c.origin-origin).length()>fastMove;
+    distMd = calcRayColision(physic,vinv,target,tr,dist,padding,fast);
+    }
+
+  c.valid  = true;
+  c.age    = 0;
+  c.target = target;
+  c.origin = origin;
+  c.spin   = rotSpin;
+  c.dist   = dist;
+  c.result = std::max(minDist,distMd);
+  return c.result;
+  }
+
+float Camera::calcRayColision(DynamicWorld& physic, const Matrix4x4& vinv, const Vec3& target, const Vec3& tr,
+                              float dist, float padding, bool sparse) const {
+  float distMd = dist;
   static int n = 1, nn=1;
   for(int i=-n;i<=n;++i)
     for(int r=-n;r<=n;++r) {
+      if(sparse && (i==0)!=(r==0))
+        continue;
       raysCasted++;
       float u = float(i)/float(nn),v = float(r)/float(nn);
       Tempest::Vec3 r0 = target;
@@ -752,7 +806,7 @@ float Camera::calcCameraColision(const Vec3& target, const Vec3& origin, const V
       if(md<distMd)
         distMd=md;
       }
-  return std::max(minDist,distMd);
+  return distMd;
   }
 
 Matrix4x4 Camera::mkView(const Vec3& pos, const Vec3& spin) const {
@@ -803,9 +857,15 @@ void Camera::debugDraw(DbgPainter& p) {
   auto& fnt = Resources::font();
   int   y   = 300+fnt.pixelSize();
 
-  string_frm buf("RaysCasted: ",raysCasted);
+  string_frm buf("RaysCasted: ",raysCasted,raysReused ? " (reused)" : "");
   p.drawText(8,y,buf); y += fnt.pixelSize();
 
+  if(auto w = Gothic::inst().world()) {
+    auto st = w->physic()->probeCacheStats();
+    buf = string_frm("ProbeCache: hit=",size_t(st.hit)," miss=",size_t(st.miss)," size=",st.size);
+    p.drawText(8,y,buf); y += fnt.pixelSize();
+    }
+
   buf = string_frm("PlayerPos : ",dst.target.x, ' ', dst.target.y, ' ', dst.target.z);
   p.drawText(8,y,buf); y += fnt.pixelSize();
 
@@ -8,6 +8,7 @@
 #include <phoenix/ext/daedalus_classes.hh>
 
 class World;
+class DynamicWorld;
 class Npc;
 class DbgPainter;
 class Serialize;
@@ -47,6 +48,7 @@ class Camera final {
 
     void reset();
     void reset(const Npc* pl);
+    void onWorldChanged();
 
     void save(Serialize &s);
     void load(Serialize &s,Npc* pl);
@@ -124,6 +126,16 @@ class Camera final {
       Tempest::Vec3       spin   = {};
       };
 
+    struct ColisionCache {
+      bool                valid   = false;
+      uint8_t             age     = 0;
+      Tempest::Vec3       target  = {};
+      Tempest::Vec3       origin  = {};
+      Tempest::Vec3       spin    = {};
+      float               dist    = 0;
+      float               result  = 0;
+      };
+
     Tempest::Vec3         cameraPos       = {};
     Tempest::Vec3         origin          = {};
     Tempest::Vec3         rotOffset       = {};
@@ -151,6 +163,8 @@ class Camera final {
     bool                  inWater       = false;
 
     mutable int           raysCasted = 0;
+    mutable bool          raysReused = false;
+    mutable ColisionCache colCache;
 
     static float          maxDist;
     static float          baseSpeeed;
@@ -162,6 +176,8 @@ class Camera final {
     Tempest::Vec3         calcOffsetAngles(const Tempest::Vec3& srcOrigin, const Tempest::Vec3& target) const;
     Tempest::Vec3         calcOffsetAngles(Tempest::Vec3 srcOrigin, Tempest::Vec3 dstOrigin, Tempest::Vec3 target) const;
     float                 calcCameraColision(const Tempest::Vec3& target, const Tempest::Vec3& origin, const Tempest::Vec3& rotSpin, float dist) const;
+    float                 calcRayColision(DynamicWorld& physic, const Tempest::Matrix4x4& vinv, const Tempest::Vec3& target,
+                                          const Tempest::Vec3& tr, float dist, float padding, bool sparse) const;
 
     void                  implMove(Tempest::KeyEvent::KeyType t, uint64_t dt);
     Tempest::Matrix4x4    mkView    (const Tempest::Vec3& pos, const Tempest::Vec3& spin) const;
@@ -3,6 +3,10 @@
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
 #include <cstring>
+#include <charconv>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
 #include <filesystem>
 
 #include "utils/installdetect.h"
@@ -74,6 +78,35 @@ CommandLine::CommandLine(int argc, const char** argv) {
       if(i<argc)
         isRQuery = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
       }
+    else if(arg=="-texcache") {
+      ++i;
+      if(i<argc)
+        isTexCache = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
+      }
+    else if(arg=="-muscache") {
+      ++i;
+      if(i<argc)
+        isMusCache = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
+      }
+    else if(arg=="-bvhcache") {
+      ++i;
+      if(i<argc)
+        bvhCache   = (std::string_view(argv[i])!="0" && std::string_view(argv[i])!="false");
+      }
+    else if(arg=="-rbudget") {
+      // resident budget for world assets, in megabytes
+      ++i;
+      if(i<argc) {
+        std::string_view v   = argv[i];
+        size_t           mb  = 0;
+        auto             err = std::from_chars(v.data(),v.data()+v.size(),mb);
+        if(err.ec==std::errc() && err.ptr==v.data()+v.size() && mb<=std::numeric_limits<size_t>::max()/(1024*1024)) {
+          resBudget = mb*1024*1024;
+          } else {
+          Log::e("-rbudget: invalid value \"",v,"\", expected megabytes");
+          }
+        }
+      }
     else if(arg=="-ms") {
       ++i;
       if(i<argc)
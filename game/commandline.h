@@ -28,10 +28,14 @@ class CommandLine {
     bool                isWindowMode()     const { return isWindow; }
     bool                isRayQuery()       const { return isRQuery; }
     bool                isMeshShading()    const { return isMeshSh; }
+    bool                isTextureCache()   const { return isTexCache; }
+    bool                isMusicCache()     const { return isMusCache; }
+    bool                isBvhCache()       const { return bvhCache;   }
     bool                doStartMenu()      const { return !noMenu;  }
     bool                doForceG1()        const { return forceG1;  }
     bool                doForceG2()        const { return forceG2;  }
     std::string_view    defaultSave()      const { return saveDef;  }
+    size_t              resourceBudget()   const { return resBudget; }
 
     std::string         wrldDef;
 
@@ -52,7 +56,11 @@ class CommandLine {
     bool                isRQuery = true;
     bool                isMeshSh = true;
 #endif
+    bool                isTexCache = true;
+    bool                isMusCache = true;
+    bool                bvhCache   = true;
     bool                forceG1  = false;
     bool                forceG2  = false;
+    size_t              resBudget = 512*1024*1024;
   };
 
@@ -1,6 +1,7 @@
 #include "hydra.h"
 
 #include "dlscollection.h"
+#include "samplebank.h"
 
 #define TSF_IMPLEMENTATION
 // #define TSF_STATIC
@@ -16,10 +17,6 @@
 
 using namespace Dx8;
 
-enum {
-  kTerminatorSampleLength=46
-  };
-
 static bool compValue(const tsf_hydra_phdr& a,const tsf_hydra_phdr& b){
   return
       std::memcmp(a.presetName,b.presetName,20)==0 &&
@@ -181,7 +178,8 @@ uint16_t Hydra::mkGeneratorOp(uint16_t usDestination) {
 
 Hydra::Hydra(const DlsCollection &dls,const std::vector<Wave>& wave) {
   std::vector<tsf_hydra_shdr> samples;
-  wdata = allocSamples(wave,samples,wdataSize);
+  bank = SampleBank::get(wave);
+  mkSamples(wave,*bank,samples);
 
   const uint16_t modIndex     = 0;
   const uint16_t instModNdx   = 0;
@@ -296,6 +294,138 @@ bool Hydra::hasNotes(tsf *tsf) {
   return false;
   }
 
+tsf* Hydra::toVoicePool(tsf* font, int maxVoices) {
+  tsf* res = reinterpret_cast<tsf*>(TSF_MALLOC(sizeof(tsf)));
+  TSF_MEMSET(res, 0, sizeof(tsf));
+  res->presets     = font->presets;
+  res->presetNum   = font->presetNum;
+  res->fontSamples = font->fontSamples;
+  res->voices      = reinterpret_cast<tsf_voice*>(TSF_MALLOC(size_t(maxVoices)*sizeof(tsf_voice)));
+  res->voiceNum    = maxVoices;
+  TSF_MEMSET(res->voices, 0, size_t(maxVoices)*sizeof(tsf_voice));
+  for(int i=0; i<maxVoices; ++i)
+    res->voices[i].playingPreset = -1;
+  tsf_set_output(res,TSF_STEREO_INTERLEAVED,44100,0);
+  return res;
+  }
+
+void Hydra::finalizeVoicePool(tsf* pool) {
+  // presets and samples are owned by the shared font
+  TSF_FREE(pool->voices);
+  TSF_FREE(pool);
+  }
+
+static void voicePan(tsf_voice& v, float pan) {
+  const float p = v.region->pan + pan - 0.5f;
+  if(p<=-0.5f) {
+    v.panFactorLeft  = 1.f;
+    v.panFactorRight = 0.f;
+    } else if(p>=0.5f) {
+    v.panFactorLeft  = 0.f;
+    v.panFactorRight = 1.f;
+    } else {
+    v.panFactorLeft  = TSF_SQRTF(0.5f - p);
+    v.panFactorRight = TSF_SQRTF(0.5f + p);
+    }
+  }
+
+static tsf_voice* allocVoice(tsf* f, int playIndex) {
+  tsf_voice *v = f->voices, *vEnd = v + f->voiceNum;
+  for(; v!=vEnd; ++v)
+    if(v->playingPreset==-1)
+      return v;
+
+  // pool is full: steal oldest released voice, or oldest voice of another note
+  tsf_voice* steal = nullptr;
+  for(v = f->voices; v!=vEnd; ++v) {
+    if(v->playIndex==playIndex)
+      continue;
+    if(steal==nullptr) {
+      steal = v;
+      continue;
+      }
+    const bool relV = v->ampenv.segment    >=TSF_SEGMENT_RELEASE;
+    const bool relS = steal->ampenv.segment>=TSF_SEGMENT_RELEASE;
+    if(relV!=relS) {
+      if(relV)
+        steal = v;
+      continue;
+      }
+    if(v->playIndex<steal->playIndex)
+      steal = v;
+    }
+  return steal;
+  }
+
+int Hydra::noteOn(tsf* f, int presetIndex, int key, float vel, float pan) {
+  if(presetIndex<0 || presetIndex>=f->presetNum || vel<=0.f)
+    return -1;
+
+  const short midiVelocity = short(vel*127);
+  const int   playIndex    = f->voicePlayIndex++;
+
+  auto& preset = f->presets[presetIndex];
+  for(auto region = preset.regions, regionEnd = region + preset.regionNum; region!=regionEnd; ++region) {
+    if(key<region->lokey || key>region->hikey || midiVelocity<region->lovel || midiVelocity>region->hivel)
+      continue;
+
+    if(region->group) {
+      for(tsf_voice *v = f->voices, *vEnd = v + f->voiceNum; v!=vEnd; ++v)
+        if(v->playingPreset==presetIndex && v->region->group==region->group)
+          tsf_voice_endquick(v, f->outSampleRate);
+      }
+
+    tsf_voice* voice = allocVoice(f,playIndex);
+    if(voice==nullptr)
+      break;
+
+    voice->region        = region;
+    voice->playingPreset = presetIndex;
+    voice->playingKey    = key;
+    voice->playIndex     = playIndex;
+    voice->noteGainDB    = f->globalGainDB - region->attenuation - tsf_gainToDecibels(1.0f / vel);
+
+    tsf_voice_calcpitchratio(voice, 0, f->outSampleRate);
+    voicePan(*voice,pan);
+
+    voice->sourceSamplePosition = region->offset;
+
+    bool doLoop = (region->loop_mode != TSF_LOOPMODE_NONE && region->loop_start < region->loop_end);
+    voice->loopStart = (doLoop ? region->loop_start : 0);
+    voice->loopEnd   = (doLoop ? region->loop_end   : 0);
+
+    tsf_voice_envelope_setup(&voice->ampenv, &region->ampenv, key, midiVelocity, TSF_TRUE,  f->outSampleRate);
+    tsf_voice_envelope_setup(&voice->modenv, &region->modenv, key, midiVelocity, TSF_FALSE, f->outSampleRate);
+
+    float filterQDB = region->initialFilterQ / 10.0f;
+    voice->lowpass.QInv   = 1.0 / TSF_POW(10.0, (filterQDB / 20.0));
+    voice->lowpass.z1     = voice->lowpass.z2 = 0;
+    voice->lowpass.active = (region->initialFilterFc <= 13500);
+    if(voice->lowpass.active)
+      tsf_voice_lowpass_setup(&voice->lowpass, tsf_cents2Hertz((float)region->initialFilterFc) / f->outSampleRate);
+
+    tsf_voice_lfo_setup(&voice->modlfo, region->delayModLFO, region->freqModLFO, f->outSampleRate);
+    tsf_voice_lfo_setup(&voice->viblfo, region->delayVibLFO, region->freqVibLFO, f->outSampleRate);
+    }
+  return playIndex;
+  }
+
+void Hydra::noteOff(tsf* f, int playIndex) {
+  tsf_voice *v = f->voices, *vEnd = v + f->voiceNum;
+  for(; v!=vEnd; ++v) {
+    if(v->playingPreset==-1 || v->playIndex!=playIndex || v->ampenv.segment>=TSF_SEGMENT_RELEASE)
+      continue;
+    tsf_voice_end(v, f->outSampleRate);
+    }
+  }
+
+void Hydra::setPan(tsf* f, float pan) {
+  tsf_voice *v = f->voices, *vEnd = v + f->voiceNum;
+  for(; v!=vEnd; ++v)
+    if(v->playingPreset!=-1)
+      voicePan(*v,pan);
+  }
+
 tsf *Hydra::toTsf() {
   tsf_hydra hydra={};
   toTsf(hydra);
@@ -306,8 +436,9 @@ tsf *Hydra::toTsf() {
   res->presetNum     = hydra.phdrNum - 1;
   res->presets       = reinterpret_cast<tsf_preset*>(TSF_MALLOC(size_t(res->presetNum)*sizeof(tsf_preset)));
 
-  res->fontSamples   = wdata.get();
-  tsf_load_presets(res, &hydra, unsigned(wdataSize));
+  // samples are shared between collections; finalize() detaches them before tsf_close
+  res->fontSamples   = const_cast<float*>(bank->data());
+  tsf_load_presets(res, &hydra, unsigned(bank->size()));
   return res;
   }
 
@@ -340,17 +471,15 @@ void Hydra::toTsf(tsf_hydra &out) {
   out.shdrs   = shdr.data();
   }
 
-std::unique_ptr<float[]> Hydra::allocSamples(const std::vector<Wave>& wave,std::vector<tsf_hydra_shdr>& smp,size_t& count) {
-  size_t wavStart=0;
-  for(const auto& wav : wave) {
-    if(wav.wfmt.wBitsPerSample!=16)
-      throw std::runtime_error("Unexpected DLS sample format");
-    const size_t wavSize = wav.wavedata.size()/(sizeof(int16_t));
+void Hydra::mkSamples(const std::vector<Wave>& wave, const SampleBank& bank, std::vector<tsf_hydra_shdr>& smp) {
+  for(size_t i=0; i<wave.size(); ++i) {
+    const auto& wav = wave[i];
+    const auto& r   = bank.waves()[i];
 
     tsf_hydra_shdr sx={};
     std::strncpy(sx.sampleName,wav.info.inam.c_str(),19);
-    sx.start           = tsf_u32(wavStart);
-    sx.end             = tsf_u32(wavStart+wavSize);
+    sx.start           = tsf_u32(r.start);
+    sx.end             = tsf_u32(r.start+r.size);
     sx.startLoop       = 0; // will be overridden, later
     sx.endLoop         = 0;
     sx.sampleRate      = wav.wfmt.dwSamplesPerSec;
@@ -359,27 +488,7 @@ std::unique_ptr<float[]> Hydra::allocSamples(const std::vector<Wave>& wave,std::
     sx.sampleLink      = 0;
     sx.sampleType      = 1; // mono
     smp.push_back(sx);
-
-    wavStart += wavSize;
-    wavStart += kTerminatorSampleLength;
-    }
-
-  std::unique_ptr<float[]> samples(new float[wavStart]);
-  float* wr = samples.get();
-
-  // exception safe
-  for(const auto& wav : wave) {
-    wav.toFloatSamples(wr);
-    wr+=wav.wavedata.size()/sizeof(int16_t);
-
-    // terminator samples.
-    for(size_t i=0; i<kTerminatorSampleLength; i++) {
-      *wr = 0.f;
-      ++wr;
-      }
     }
-  count = wavStart;
-  return samples;
   }
 
 bool Hydra::validate(const tsf_hydra &tsf) const {
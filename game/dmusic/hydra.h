@@ -19,6 +19,7 @@ struct tsf;
 namespace Dx8 {
 
 class DlsCollection;
+class SampleBank;
 class Wave;
 
 class Hydra {
@@ -64,6 +65,13 @@ class Hydra {
     static void finalize(tsf* tsf);
     static bool hasNotes(tsf* tsf);
 
+    // voice pool: shares presets and samples with 'font', owns only preallocated voices
+    static tsf* toVoicePool       (tsf* font, int maxVoices);
+    static void finalizeVoicePool (tsf* pool);
+    static int  noteOn            (tsf* pool, int preset, int key, float vel, float pan);
+    static void noteOff           (tsf* pool, int playIndex);
+    static void setPan            (tsf* pool, float pan);
+
     tsf* toTsf   ();
     void toTsf   (tsf_hydra& out);
     bool validate(const tsf_hydra& tsf) const;
@@ -78,12 +86,11 @@ class Hydra {
     std::vector<tsf_hydra_igen> igen;
     std::vector<tsf_hydra_shdr> shdr;
 
-    std::unique_ptr<float[]>    wdata;
-    size_t                      wdataSize=0;
+    std::shared_ptr<const SampleBank> bank;
 
   private:
     static uint16_t          mkGeneratorOp(uint16_t usDestination);
-    std::unique_ptr<float[]> allocSamples(const std::vector<Dx8::Wave>& wave, std::vector<tsf_hydra_shdr> &samples, size_t &count);
+    static void              mkSamples(const std::vector<Dx8::Wave>& wave, const SampleBank& bank, std::vector<tsf_hydra_shdr> &samples);
   };
 
 }
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <set>
 
+#include "mixersimd.h"
 #include "soundfont.h"
 #include "wave.h"
 
@@ -332,28 +333,19 @@ void Mixer::implMix(PatternInternal &pptn, float volume, int16_t *out, size_t cn
     const bool hasVol = hasVolumeCurves(pptn,i);
     if(hasVol) {
       volFromCurve(pptn,i,vol);
-      for(size_t r=0;r<cnt2;++r) {
-        float v = vol[r/2];
-        pcmMix[r] += pcm[r]*insVolume*(v*v);
-        }
+      MixerSimd::mixAccumulate(pcmMix.data(),pcm.data(),insVolume,vol.data(),cnt);
       } else {
-      for(size_t r=0;r<cnt2;++r) {
-        float v = i.volLast;
-        pcmMix[r] += pcm[r]*insVolume*(v*v);
-        }
+      float v = i.volLast;
+      MixerSimd::mixAccumulate(pcmMix.data(),pcm.data(),insVolume*(v*v),cnt2);
       }
     }
 
-  for(size_t i=0;i<cnt2;++i) {
-    float v = pcmMix[i]*volume;
-    out[i] = (v < -1.00004566f ? int16_t(-32768) : (v > 1.00001514f ? int16_t(32767) : int16_t(v * 32767.5f)));
-    }
+  MixerSimd::toInt16(out,pcmMix.data(),volume,cnt2);
   }
 
 void Mixer::volFromCurve(PatternInternal &part,Instr& inst,std::vector<float> &v) {
   float& base = inst.volLast;
-  for(auto& i:v)
-    i=base;
+  std::fill(v.begin(),v.end(),base);
 
   const int64_t shift = sampleCursor-patStart;
   //const int64_t e = s+v.size();
@@ -375,41 +367,37 @@ void Mixer::volFromCurve(PatternInternal &part,Instr& inst,std::vector<float> &v
     const float  diffV = i.endV-i.startV;
     const float  shift = i.startV;
     const float  endV  = i.endV;
+    float*       dst   = v.data();
 
     switch(i.shape) {
       case DMUS_CURVES_LINEAR: {
-        for(size_t i=begin;i<size;++i) {
-          float val = (float(i)-float(s))/range;
-          v[i] = val*diffV+shift;
-          }
+        MixerSimd::curveRamp (dst,begin,size,float(s),range);
+        MixerSimd::curveScale(dst,begin,size,diffV,shift);
         break;
         }
       case DMUS_CURVES_INSTANT: {
-        for(size_t i=begin;i<size;++i) {
-          v[i] = endV;
-          }
+        std::fill(dst+begin,dst+std::max(begin,size),endV);
         break;
         }
       case DMUS_CURVES_EXP: {
-        for(size_t i=begin;i<size;++i) {
-          float val = (float(i)-float(s))/range;
-          v[i] = std::pow(val,2.f)*diffV+shift;
-          }
+        MixerSimd::curveRamp(dst,begin,size,float(s),range);
+        for(size_t i=begin;i<size;++i)
+          dst[i] = dst[i]*dst[i];
+        MixerSimd::curveScale(dst,begin,size,diffV,shift);
         break;
         }
       case DMUS_CURVES_LOG: {
-        for(size_t i=begin;i<size;++i) {
-          float val = (float(i)-float(s))/range;
-          v[i] = std::sqrt(val)*diffV+shift;
-          }
+        MixerSimd::curveRamp(dst,begin,size,float(s),range);
+        for(size_t i=begin;i<size;++i)
+          dst[i] = std::sqrt(dst[i]);
+        MixerSimd::curveScale(dst,begin,size,diffV,shift);
         break;
         }
       case DMUS_CURVES_SINE: {
-        for(size_t i=begin;i<size;++i) {
-          float linear = (float(i)-float(s))/range;
-          float val    = std::sin(float(M_PI)*linear*0.5f);
-          v[i] = val*diffV+shift;
-          }
+        MixerSimd::curveRamp(dst,begin,size,float(s),range);
+        for(size_t i=begin;i<size;++i)
+          dst[i] = std::sin(float(M_PI)*dst[i]*0.5f);
+        MixerSimd::curveScale(dst,begin,size,diffV,shift);
         break;
         }
       }
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define DX8_MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define DX8_MIXER_NEON
+#endif
+
+// Mixer inner loops, internal to Dx8::Mixer. Vector versions use SSE2 or NEON, where available,
+// and finish their tails with the reference loops from MixerSimd::Scalar.
+namespace Dx8 {
+namespace MixerSimd {
+
+namespace Scalar {
+
+inline void mixAccumulate(float* dst, const float* src, float gain, size_t cnt) {
+  for(size_t i=0; i<cnt; ++i)
+    dst[i] += src[i]*gain;
+  }
+
+inline void mixAccumulate(float* dst, const float* src, float gain, const float* vol, size_t frames) {
+  for(size_t i=0; i<frames; ++i) {
+    const float v = vol[i];
+    dst[i*2  ] += src[i*2  ]*gain*(v*v);
+    dst[i*2+1] += src[i*2+1]*gain*(v*v);
+    }
+  }
+
+inline int16_t toInt16(float v) {
+  return (v < -1.00004566f ? int16_t(-32768) : (v > 1.00001514f ? int16_t(32767) : int16_t(v * 32767.5f)));
+  }
+
+inline void toInt16(int16_t* out, const float* src, float volume, size_t cnt) {
+  for(size_t i=0; i<cnt; ++i)
+    out[i] = toInt16(src[i]*volume);
+  }
+
+inline void curveRamp(float* v, size_t begin, size_t end, float s, float range) {
+  for(size_t i=begin; i<end; ++i)
+    v[i] = (float(i)-s)/range;
+  }
+
+inline void curveScale(float* v, size_t begin, size_t end, float diff, float shift) {
+  for(size_t i=begin; i<end; ++i)
+    v[i] = v[i]*diff+shift;
+  }
+
+}
+
+// dst[i] += src[i]*gain
+inline void mixAccumulate(float* dst, const float* src, float gain, size_t cnt) {
+  size_t i = 0;
+#if defined(DX8_MIXER_SSE2)
+  const __m128 g = _mm_set1_ps(gain);
+  for(; i+4<=cnt; i+=4) {
+    __m128 s = _mm_mul_ps(_mm_loadu_ps(src+i),g);
+    _mm_storeu_ps(dst+i,_mm_add_ps(_mm_loadu_ps(dst+i),s));
+    }
+#elif defined(DX8_MIXER_NEON)
+  const float32x4_t g = vdupq_n_f32(gain);
+  for(; i+4<=cnt; i+=4) {
+    float32x4_t s = vmulq_f32(vld1q_f32(src+i),g);
+    vst1q_f32(dst+i,vaddq_f32(vld1q_f32(dst+i),s));
+    }
+#endif
+  Scalar::mixAccumulate(dst+i,src+i,gain,cnt-i);
+  }
+
+// stereo: dst[2*i+c] += src[2*i+c]*gain*(vol[i]*vol[i])
+inline void mixAccumulate(float* dst, const float* src, float gain, const float* vol, size_t frames) {
+  size_t i = 0;
+#if defined(DX8_MIXER_SSE2)
+  const __m128 g = _mm_set1_ps(gain);
+  for(; i+4<=frames; i+=4) {
+    __m128 v  = _mm_loadu_ps(vol+i);
+    v = _mm_mul_ps(v,v);
+    __m128 s0 = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src+i*2  ),g),_mm_unpacklo_ps(v,v));
+    __m128 s1 = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src+i*2+4),g),_mm_unpackhi_ps(v,v));
+    _mm_storeu_ps(dst+i*2,  _mm_add_ps(_mm_loadu_ps(dst+i*2  ),s0));
+    _mm_storeu_ps(dst+i*2+4,_mm_add_ps(_mm_loadu_ps(dst+i*2+4),s1));
+    }
+#elif defined(DX8_MIXER_NEON)
+  const float32x4_t g = vdupq_n_f32(gain);
+  for(; i+4<=frames; i+=4) {
+    float32x4_t   v  = vld1q_f32(vol+i);
+    v = vmulq_f32(v,v);
+    float32x4x2_t vv = vzipq_f32(v,v);
+    float32x4_t   s0 = vmulq_f32(vmulq_f32(vld1q_f32(src+i*2  ),g),vv.val[0]);
+    float32x4_t   s1 = vmulq_f32(vmulq_f32(vld1q_f32(src+i*2+4),g),vv.val[1]);
+    vst1q_f32(dst+i*2,  vaddq_f32(vld1q_f32(dst+i*2  ),s0));
+    vst1q_f32(dst+i*2+4,vaddq_f32(vld1q_f32(dst+i*2+4),s1));
+    }
+#endif
+  Scalar::mixAccumulate(dst+i*2,src+i*2,gain,vol+i,frames-i);
+  }
+
+// out[i] = saturate(src[i]*volume); matches Scalar::toInt16 exactly
+inline void toInt16(int16_t* out, const float* src, float volume, size_t cnt) {
+  size_t i = 0;
+#if defined(DX8_MIXER_SSE2)
+  const __m128 g  = _mm_set1_ps(volume);
+  const __m128 k  = _mm_set1_ps(32767.5f);
+  const __m128 lo = _mm_set1_ps(-32769.f);
+  const __m128 hi = _mm_set1_ps( 32768.f);
+  for(; i+8<=cnt; i+=8) {
+    __m128  a  = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src+i  ),g),k);
+    __m128  b  = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(src+i+4),g),k);
+    // clamp first: cvtt returns INT_MIN on overflow
+    a = _mm_min_ps(_mm_max_ps(a,lo),hi);
+    b = _mm_min_ps(_mm_max_ps(b,lo),hi);
+    __m128i r = _mm_packs_epi32(_mm_cvttps_epi32(a),_mm_cvttps_epi32(b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out+i),r);
+    }
+#elif defined(DX8_MIXER_NEON)
+  const float32x4_t g = vdupq_n_f32(volume);
+  const float32x4_t k = vdupq_n_f32(32767.5f);
+  for(; i+8<=cnt; i+=8) {
+    float32x4_t a = vmulq_f32(vmulq_f32(vld1q_f32(src+i  ),g),k);
+    float32x4_t b = vmulq_f32(vmulq_f32(vld1q_f32(src+i+4),g),k);
+    int16x8_t   r = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)),vqmovn_s32(vcvtq_s32_f32(b)));
+    vst1q_s16(out+i,r);
+    }
+#endif
+  Scalar::toInt16(out+i,src+i,volume,cnt-i);
+  }
+
+// v[i] = (float(i)-s)/range, for i in [begin,end)
+inline void curveRamp(float* v, size_t begin, size_t end, float s, float range) {
+  size_t i = begin;
+#if defined(DX8_MIXER_SSE2)
+  const __m128  fs   = _mm_set1_ps(s);
+  const __m128  fr   = _mm_set1_ps(range);
+  const __m128i step = _mm_set1_epi32(4);
+  __m128i       id   = _mm_setr_epi32(int32_t(i),int32_t(i+1),int32_t(i+2),int32_t(i+3));
+  for(; i+4<=end; i+=4) {
+    __m128 fi = _mm_cvtepi32_ps(id);
+    _mm_storeu_ps(v+i,_mm_div_ps(_mm_sub_ps(fi,fs),fr));
+    id = _mm_add_epi32(id,step);
+    }
+#elif defined(DX8_MIXER_NEON)
+  const float32x4_t fs   = vdupq_n_f32(s);
+  const float32x4_t fr   = vdupq_n_f32(1.f/range);
+  const int32x4_t   step = vdupq_n_s32(4);
+  const int32_t     id0[4] = {int32_t(i),int32_t(i+1),int32_t(i+2),int32_t(i+3)};
+  int32x4_t         id   = vld1q_s32(id0);
+  for(; i+4<=end; i+=4) {
+    // armv7 has no vector division
+    vst1q_f32(v+i,vmulq_f32(vsubq_f32(vcvtq_f32_s32(id),fs),fr));
+    id = vaddq_s32(id,step);
+    }
+#endif
+  Scalar::curveRamp(v,i,end,s,range);
+  }
+
+// v[i] = v[i]*diff+shift
+inline void curveScale(float* v, size_t begin, size_t end, float diff, float shift) {
+  size_t i = begin;
+#if defined(DX8_MIXER_SSE2)
+  const __m128 d = _mm_set1_ps(diff);
+  const __m128 s = _mm_set1_ps(shift);
+  for(; i+4<=end; i+=4)
+    _mm_storeu_ps(v+i,_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(v+i),d),s));
+#elif defined(DX8_MIXER_NEON)
+  const float32x4_t d = vdupq_n_f32(diff);
+  const float32x4_t s = vdupq_n_f32(shift);
+  for(; i+4<=end; i+=4)
+    vst1q_f32(v+i,vaddq_f32(vmulq_f32(vld1q_f32(v+i),d),s));
+#endif
+  Scalar::curveScale(v,i,end,diff,shift);
+  }
+
+}
+}
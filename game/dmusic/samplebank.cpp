@@ -0,0 +1,172 @@
+#include "samplebank.h"
+
+#include <unordered_map>
+#include <stdexcept>
+#include <cstring>
+#include <future>
+#include <mutex>
+
+#include "utils/diskcache.h"
+#include "utils/fnvhash.h"
+#include "wave.h"
+
+using namespace Dx8;
+
+enum {
+  kTerminatorSampleLength=46
+  };
+
+namespace {
+struct BankEntry final {
+  SampleBank::Key                                       key;
+  std::weak_ptr<const SampleBank>                       bank;
+  std::shared_future<std::shared_ptr<const SampleBank>> pending; // valid, while bank is decoded
+  };
+}
+
+static std::mutex                                   bankSync;
+static std::unordered_multimap<uint64_t,BankEntry>  banks;
+static std::shared_ptr<const DiskCache>             diskCache;
+
+// disk entry is accepted only for exactly same wave pool
+static std::vector<uint64_t> diskMeta(const SampleBank::Key& key, size_t count) {
+  std::vector<uint64_t> ret;
+  ret.push_back(key.hash.size());
+  ret.push_back(count);
+  ret.insert(ret.end(),key.hash .begin(),key.hash .end());
+  ret.insert(ret.end(),key.count.begin(),key.count.end());
+  return ret;
+  }
+
+uint64_t SampleBank::Key::combined() const {
+  uint64_t h = FnvHash::basis;
+  for(size_t i=0; i<hash.size(); ++i) {
+    h = FnvHash::mix(h,hash[i]);
+    h = FnvHash::mix(h,count[i]);
+    }
+  return h;
+  }
+
+void SampleBank::setDiskCache(std::u16string dir) {
+  auto d = std::make_shared<const DiskCache>(std::move(dir),"dls cache",u".smp","OGDS",uint32_t(Version));
+  std::lock_guard<std::mutex> guard(bankSync);
+  diskCache = d->isOpen() ? d : nullptr;
+  }
+
+std::shared_ptr<const SampleBank> SampleBank::get(const std::vector<Wave>& wave) {
+  Key key;
+  key.hash .resize(wave.size());
+  key.count.resize(wave.size());
+  for(size_t i=0; i<wave.size(); ++i) {
+    key.hash [i] = wave[i].contentHash(FnvHash::basis);
+    key.count[i] = wave[i].sampleCount();
+    }
+  const uint64_t h = key.combined();
+
+  std::promise<std::shared_ptr<const SampleBank>> promise;
+  std::shared_ptr<const DiskCache>                dsk;
+  BankEntry*                                      self = nullptr;
+  {
+  std::unique_lock<std::mutex> guard(bankSync);
+  for(auto it=banks.begin(); it!=banks.end();) {
+    auto& e = it->second;
+    if(!e.pending.valid() && e.bank.expired())
+      it = banks.erase(it); else
+      ++it;
+    }
+
+  auto rng = banks.equal_range(h);
+  for(auto it=rng.first; it!=rng.second; ++it) {
+    auto& e = it->second;
+    if(!(e.key==key))
+      continue;
+    if(auto b = e.bank.lock())
+      return b;
+    if(e.pending.valid()) {
+      // same pool is decoded by another thread
+      auto fut = e.pending;
+      guard.unlock();
+      return fut.get();
+      }
+    }
+
+  // pending entries are never erased by others, so pointer stays valid
+  auto ins = banks.emplace(h,BankEntry());
+  self          = &ins->second;
+  self->key     = key;
+  self->pending = promise.get_future().share();
+  dsk           = diskCache;
+  }
+
+  // decode outside of lock: different pools are decoded in parallel
+  std::shared_ptr<const SampleBank> bank;
+  try {
+    bank = decode(wave,key,dsk.get());
+    }
+  catch(...) {
+    std::lock_guard<std::mutex> guard(bankSync);
+    auto rng = banks.equal_range(h);
+    for(auto it=rng.first; it!=rng.second; ++it)
+      if(&it->second==self) {
+        banks.erase(it);
+        break;
+        }
+    promise.set_exception(std::current_exception());
+    throw;
+    }
+
+  std::lock_guard<std::mutex> guard(bankSync);
+  self->bank    = bank;
+  self->pending = std::shared_future<std::shared_ptr<const SampleBank>>();
+  promise.set_value(bank);
+  return bank;
+  }
+
+std::shared_ptr<const SampleBank> SampleBank::decode(const std::vector<Wave>& wave, const Key& key, const DiskCache* disk) {
+  std::shared_ptr<SampleBank> bank(new SampleBank());
+  bank->range.resize(wave.size());
+
+  size_t wavStart=0;
+  for(size_t i=0; i<wave.size(); ++i) {
+    auto& wav = wave[i];
+    if(wav.wfmt.wFormatTag!=Wave::ADPCM && wav.wfmt.wBitsPerSample!=16)
+      throw std::runtime_error("Unexpected DLS sample format");
+    bank->range[i].start = wavStart;
+    bank->range[i].size  = size_t(key.count[i]);
+    wavStart += bank->range[i].size;
+    wavStart += kTerminatorSampleLength;
+    }
+  bank->count = wavStart;
+
+  std::unique_ptr<int16_t[]> pcm(new int16_t[wavStart]);
+  if(disk==nullptr || !loadDisk(*disk,key,pcm.get(),wavStart)) {
+    for(size_t i=0; i<wave.size(); ++i) {
+      auto& r = bank->range[i];
+      wave[i].toPcmSamples(pcm.get()+r.start);
+      // terminator samples.
+      std::memset(pcm.get()+r.start+r.size,0,kTerminatorSampleLength*sizeof(int16_t));
+      }
+    if(disk!=nullptr)
+      storeDisk(*disk,key,pcm.get(),wavStart);
+    }
+
+  bank->samples.reset(new float[wavStart]);
+  for(size_t i=0; i<wavStart; ++i)
+    bank->samples[i] = pcm[i]/32767.f;
+  return bank;
+  }
+
+bool SampleBank::loadDisk(const DiskCache& disk, const Key& key, int16_t* pcm, size_t count) {
+  const auto            expect = diskMeta(key,count);
+  std::vector<uint64_t> meta(expect.size());
+  return disk.load(key.combined(),meta.data(),meta.size()*sizeof(uint64_t),[&](size_t dataSize) -> void* {
+    if(meta!=expect || dataSize!=count*sizeof(int16_t))
+      return nullptr;
+    return pcm;
+    });
+  }
+
+void SampleBank::storeDisk(const DiskCache& disk, const Key& key, const int16_t* pcm, size_t count) {
+  const auto meta = diskMeta(key,count);
+  disk.store(key.combined(),meta.data(),meta.size()*sizeof(uint64_t),pcm,count*sizeof(int16_t));
+  }
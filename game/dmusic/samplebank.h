@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+class DiskCache;
+
+namespace Dx8 {
+
+class Wave;
+
+// Float samples of a DLS wave pool, laid out for tsf.
+// Banks are shared by content: collections with identical wave pools use one allocation.
+class SampleBank final {
+  public:
+    struct Range final {
+      size_t start = 0;
+      size_t size  = 0;
+      };
+
+    // identity of a wave pool: content hash and sample count of every wave
+    struct Key final {
+      std::vector<uint64_t> hash;
+      std::vector<uint64_t> count;
+
+      uint64_t combined() const;
+      bool     operator == (const Key& other) const { return hash==other.hash && count==other.count; }
+      };
+
+    static std::shared_ptr<const SampleBank> get(const std::vector<Wave>& wave);
+    static void                              setDiskCache(std::u16string dir);
+
+    const float*              data()  const { return samples.get(); }
+    size_t                    size()  const { return count;         }
+    const std::vector<Range>& waves() const { return range;         }
+
+  private:
+    SampleBank() = default;
+
+    enum {
+      Version = 2,
+      };
+
+    static std::shared_ptr<const SampleBank> decode(const std::vector<Wave>& wave, const Key& key, const DiskCache* disk);
+    static bool                              loadDisk (const DiskCache& disk, const Key& key, int16_t* pcm, size_t count);
+    static void                              storeDisk(const DiskCache& disk, const Key& key, const int16_t* pcm, size_t count);
+
+    std::unique_ptr<float[]> samples;
+    size_t                   count = 0;
+    std::vector<Range>       range;
+  };
+
+}
@@ -1,7 +1,6 @@
 #include "soundfont.h"
 
 #include <Tempest/Log>
-#include <bitset>
 
 #include "dlscollection.h"
 #include "hydra.h"
@@ -139,108 +138,58 @@ TSFDEF void __render_float(tsf* f, float* buffer, int samples, int flag_mixing)
 struct SoundFont::Data {
   Data(const DlsCollection &dls,const std::vector<Wave>& wave)
     :hydra(dls,wave) {
+    fnt = hydra.toTsf();
+    }
+
+  ~Data() {
+    Hydra::finalize(fnt);
     }
 
   Dx8::Hydra hydra;
+  tsf*       fnt=nullptr; // preset table, shared by all voice pools of this collection
   };
 
-struct SoundFont::Instance {
-  Instance(std::shared_ptr<Data> &shData,uint32_t dwPatch){
+struct SoundFont::Impl {
+  Impl(std::shared_ptr<Data> &shData,uint32_t dwPatch)
+    :shData(shData) {
     uint8_t bankHi = uint8_t((dwPatch & 0x00FF0000) >> 0x10);
     uint8_t bankLo = uint8_t((dwPatch & 0x0000FF00) >> 0x8);
     uint8_t patch  = uint8_t(dwPatch & 0x000000FF);
     int32_t bank   = (bankHi << 16) + bankLo;
 
-    fnt    = shData->hydra.toTsf();
-    preset = tsf_get_presetindex(fnt, bank, patch);
-    tsf_set_output(fnt,TSF_STEREO_INTERLEAVED,44100,0);
-    }
-
-  ~Instance(){
-    Hydra::finalize(fnt);
-    }
-
-  bool hasNotes() {
-    return Hydra::hasNotes(fnt);
-    }
-
-  void setPan(float p){
-    tsf_channel_set_pan(fnt,0,p);
-    tsf_channel_set_pan(fnt,1,p);
-    }
-
-  bool noteOn(uint8_t note, uint8_t velosity){
-    if(alloc[note]) {
-      return false;
-      }
-    alloc[note]=true;
-    tsf_note_on(fnt,preset,note,(velosity+0.5f)/127.f);
-    return true;
-    }
-
-  bool noteOff(uint8_t note){
-    if(!alloc[note])
-      return false;
-    alloc[note]=false;
-    tsf_note_off(fnt,preset,note);
-    return true;
-    }
-
-  std::bitset<256> alloc;
-  tsf*             fnt=nullptr;
-  int              preset=0;
-  };
-
-struct SoundFont::Impl {
-  Impl(std::shared_ptr<Data> &shData,uint32_t dwPatch)
-    :shData(shData), dwPatch(dwPatch) {
+    preset = tsf_get_presetindex(shData->fnt, bank, patch);
+    voices = Hydra::toVoicePool(shData->fnt,MaxVoices);
     }
 
   ~Impl() {
+    Hydra::finalizeVoicePool(voices);
     }
 
   void setPan(float p){
-    for(auto& i:inst)
-      i->setPan(p);
+    Hydra::setPan(voices,p);
     pan = p;
     }
 
-  std::shared_ptr<Instance> noteOn(uint8_t note, uint8_t velosity){
-    for(auto& i:inst){
-      if(i->noteOn(note,velosity))
-        return i;
-      }
-    auto fnt = std::make_shared<Instance>(shData,dwPatch);
-    fnt->setPan(pan);
-    fnt->noteOn(note,velosity);
-    inst.emplace_back(fnt);
-    return inst.back();
+  int32_t noteOn(uint8_t note, uint8_t velosity){
+    return Hydra::noteOn(voices,preset,note,(velosity+0.5f)/127.f,pan);
     }
 
-  /*
-  void noteOff(uint8_t note){
-    for(auto& i:inst){
-      if(i->noteOff(note))
-        return;
-      }
-    }*/
+  void noteOff(int32_t id){
+    Hydra::noteOff(voices,id);
+    }
 
   bool hasNotes() {
-    for(auto& i:inst)
-      if(i->hasNotes())
-        return true;
-    return false;
+    return Hydra::hasNotes(voices);
     }
 
   void mix(float *samples, size_t count) {
-    for(auto& i:inst)
-      tsf_render_float(i->fnt,samples,int(count),true);
+    tsf_render_float(voices,samples,int(count),true);
     }
 
-  std::shared_ptr<Data>                  shData;
-  uint32_t                               dwPatch=0;
-  float                                  pan=0.5f;
-  std::vector<std::shared_ptr<Instance>> inst;
+  std::shared_ptr<Data> shData;
+  tsf*                  voices=nullptr;
+  int                   preset=0;
+  float                 pan=0.5f;
   };
 
 SoundFont::SoundFont() {
@@ -283,15 +232,14 @@ SoundFont::Ticket SoundFont::noteOn(uint8_t note, uint8_t velosity) {
   Ticket t;
   if(impl==nullptr)
     return t;
-  t.impl = impl->noteOn(note,velosity);
-  t.note = note;
+  t.id   = impl->noteOn(note,velosity);
+  t.impl = impl;
   return t;
   }
 
 void SoundFont::noteOff(SoundFont::Ticket &t) {
   if(t.impl==nullptr)
     return;
-  auto& i = *t.impl;
-  i.noteOff(t.note);
+  t.impl->noteOff(t.id);
   }
 
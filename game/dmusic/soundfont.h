@@ -11,19 +11,19 @@ class Wave;
 class SoundFont final {
   private:
     struct Impl;
-    struct Instance;
 
   public:
     enum  {
       SampleRate = 44100,
-      BitsPerSec = SampleRate*2*16
+      BitsPerSec = SampleRate*2*16,
+      MaxVoices  = 32,
       };
     struct Data;
 
     class Ticket final {
       private:
-        std::shared_ptr<Instance> impl;
-        uint8_t                   note=0;
+        std::shared_ptr<Impl> impl;
+        int32_t               id=-1;
 
       public:
         bool operator==(const std::nullptr_t&) const {
@@ -10,6 +10,8 @@
 #include <memory>
 #include <cassert>
 
+#include "utils/fnvhash.h"
+
 template<class T>
 static T clip(T v,T low,T hi){
   if(v<low)
@@ -90,26 +92,7 @@ void Wave::implRead(Riff &input) {
     }
     if(errct>0)
       Tempest::Log::i("");
-
-    size_t blockCount = (wavedata.size()+wfmt.wBlockAlign-1) / wfmt.wBlockAlign;
-
-    /* We decode two samples per byte. There will be blockCount headers in the data chunk.
-     *  This is enough to know how to calculate the total PCM frame count. */
-    size_t totalBlockHeaderSizeInBytes = blockCount * (6*wfmt.wChannels);
-    size_t totalPCMFrameCount = ((wavedata.size() - totalBlockHeaderSizeInBytes) * 2) / wfmt.wChannels;
-
-    std::vector<uint8_t> src = std::move(wavedata);
-    wavedata.resize(totalPCMFrameCount*wfmt.wChannels*sizeof(int16_t));
-
-    Tempest::MemReader f(src.data(),src.size());
-    decodeAdpcm(f,totalPCMFrameCount,wfmt.wBlockAlign,wfmt.wChannels,reinterpret_cast<int16_t*>(wavedata.data()));
-
-    wfmt.wFormatTag       = Dx8::Wave::PCM;
-    wfmt.wChannels        = 2;
-    //wfmt.dwSamplesPerSec  = wavedata.size()/2;
-    wfmt.dwAvgBytesPerSec = wfmt.dwSamplesPerSec * uint32_t(wfmt.wChannels * sizeof(int16_t));
-    wfmt.wBlockAlign      = 2;
-    wfmt.wBitsPerSample   = 16;
+    // NOTE: decoding is deferred to toPcmSamples, so cached sample banks can skip it
     }
   }
 
@@ -273,35 +256,88 @@ size_t Wave::decodeAdpcmBlock(Tempest::MemReader& rd, const size_t framesToRead,
     }
   }
 
+size_t Wave::adpcmFrameCount() const {
+  if(wfmt.wBlockAlign==0 || wfmt.wChannels==0)
+    return 0;
+  size_t blockCount = (wavedata.size()+wfmt.wBlockAlign-1) / wfmt.wBlockAlign;
+
+  /* We decode two samples per byte. There will be blockCount headers in the data chunk.
+   *  This is enough to know how to calculate the total PCM frame count. */
+  size_t totalBlockHeaderSizeInBytes = blockCount * (6*wfmt.wChannels);
+  if(totalBlockHeaderSizeInBytes>wavedata.size())
+    return 0;
+  return ((wavedata.size() - totalBlockHeaderSizeInBytes) * 2) / wfmt.wChannels;
+  }
+
+size_t Wave::sampleCount() const {
+  if(wfmt.wFormatTag==Dx8::Wave::ADPCM)
+    return adpcmFrameCount()*wfmt.wChannels;
+  return wavedata.size()/sizeof(int16_t);
+  }
+
+uint64_t Wave::contentHash(uint64_t h) const {
+  auto mix = [&h](const void* ptr, size_t size) {
+    h = FnvHash::bytes(h,ptr,size);
+    h = FnvHash::mix(h,size);
+    };
+  mix(&wfmt,sizeof(wfmt));
+  mix(extra.data(),extra.size());
+  mix(wavedata.data(),wavedata.size());
+  return h;
+  }
+
+void Wave::toPcmSamples(int16_t* out) const {
+  if(wfmt.wFormatTag!=Dx8::Wave::ADPCM) {
+    std::memcpy(out,wavedata.data(),sampleCount()*sizeof(int16_t));
+    return;
+    }
+  const size_t frames = adpcmFrameCount();
+  std::memset(out,0,frames*wfmt.wChannels*sizeof(int16_t));
+
+  Tempest::MemReader f(wavedata.data(),wavedata.size());
+  decodeAdpcm(f,frames,wfmt.wBlockAlign,wfmt.wChannels,out);
+  }
+
 void Wave::toFloatSamples(float* out) const {
-  const int16_t* smp = reinterpret_cast<const int16_t*>(wavedata.data());
-  for(size_t i=0;i<wavedata.size();i+=sizeof(int16_t), ++smp) {
-    *out = (*smp)/32767.f;
-    ++out;
+  const size_t cnt = sampleCount();
+  if(wfmt.wFormatTag!=Dx8::Wave::ADPCM) {
+    const int16_t* smp = reinterpret_cast<const int16_t*>(wavedata.data());
+    for(size_t i=0; i<cnt; ++i)
+      out[i] = smp[i]/32767.f;
+    return;
     }
+  std::unique_ptr<int16_t[]> pcm(new int16_t[cnt]);
+  toPcmSamples(pcm.get());
+  for(size_t i=0; i<cnt; ++i)
+    out[i] = pcm[i]/32767.f;
   }
 
 void Wave::save(const char *path) const {
+  // ADPCM data is kept undecoded: always store 16-bit PCM, so the file is playable as is
+  const size_t               cnt = sampleCount();
+  std::unique_ptr<int16_t[]> pcm(new int16_t[cnt]);
+  toPcmSamples(pcm.get());
+
+  WaveFormat fmt = wfmt;
+  fmt.wFormatTag       = WaveFormatTag::PCM;
+  fmt.wBitsPerSample   = 16;
+  fmt.wBlockAlign      = uint16_t(fmt.wChannels*sizeof(int16_t));
+  fmt.dwAvgBytesPerSec = fmt.dwSamplesPerSec*fmt.wBlockAlign;
+
   Tempest::WFile f(path);
   f.write("RIFF",4);
 
-  uint32_t fmtSize = uint32_t(sizeof(wfmt)) + uint32_t(extra.size()>0 ? (2+extra.size()) : 0);
-  uint32_t sz      = 8u + fmtSize + 8u + uint32_t(wavedata.size());
+  uint32_t dataSize = uint32_t(cnt*sizeof(int16_t));
+  uint32_t fmtSize  = uint32_t(sizeof(fmt));
+  uint32_t sz       = 4u + 8u + fmtSize + 8u + dataSize;
   f.write(reinterpret_cast<const char*>(&sz),4);
   f.write("WAVE",4);
 
   f.write("fmt ",4);
-  sz=fmtSize;
-  f.write(&sz,4);
-  f.write(&wfmt,sizeof(wfmt));
-  if(extra.size()>0){
-    uint16_t sz=uint16_t(extra.size());
-    f.write(&sz,2);
-    f.write(&extra[0],extra.size());
-    }
+  f.write(&fmtSize,4);
+  f.write(&fmt,sizeof(fmt));
 
   f.write("data",4);
-  sz=uint32_t(wavedata.size());
-  f.write(&sz,4);
-  f.write(wavedata.data(),sz);
+  f.write(&dataSize,4);
+  f.write(pcm.get(),dataSize);
   }
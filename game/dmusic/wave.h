@@ -60,8 +60,12 @@ class Wave final {
     std::vector<WaveSampleLoop> loop;
     Info                        info;
 
-    void toFloatSamples(float* out) const;
+    size_t   sampleCount() const;
+    uint64_t contentHash(uint64_t h) const;
+    void     toPcmSamples  (int16_t* out) const;
+    void     toFloatSamples(float* out) const;
 
+    // writes 16-bit PCM .wav; ADPCM data is decoded first
     void save(const char* path) const;
 
   private:
@@ -95,11 +99,13 @@ class Wave final {
     void        implRead(Riff &input);
     void        implParse(Riff &input);
 
-    size_t      decodeAdpcm(Tempest::MemReader& rd, const size_t framesToRead,
-                            uint16_t blockAlign, uint16_t channels, int16_t* pBufferOut);
-    size_t      decodeAdpcmBlock(Tempest::MemReader& rd, const size_t framesToRead,
-                                 uint16_t blockAlign, uint16_t channels, int16_t* pBufferOut);
-    int32_t     decodeADPCMFrame(AdpcChannel& msadpcm, int32_t nibble);
+    size_t      adpcmFrameCount() const;
+
+    static size_t  decodeAdpcm(Tempest::MemReader& rd, const size_t framesToRead,
+                               uint16_t blockAlign, uint16_t channels, int16_t* pBufferOut);
+    static size_t  decodeAdpcmBlock(Tempest::MemReader& rd, const size_t framesToRead,
+                                    uint16_t blockAlign, uint16_t channels, int16_t* pBufferOut);
+    static int32_t decodeADPCMFrame(AdpcChannel& msadpcm, int32_t nibble);
   };
 
 }
@@ -175,9 +175,22 @@ void Mem32::copyBytes(ptr32_t psrc, ptr32_t pdst, uint32_t size) {
   }
 
 Mem32::Region* Mem32::translate(ptr32_t address) {
-  for(auto& rgn:region) {
-    if(rgn.address<=address && address<rgn.address+rgn.size)
+  // scripts tend to access same block many times in a row
+  if(lastHit<region.size()) {
+    auto& rgn = region[lastHit];
+    if(rgn.address<=address && address-rgn.address<rgn.size)
       return &rgn;
     }
-  return nullptr;
+
+  // regions are sorted by address and do not overlap
+  auto it = std::upper_bound(region.begin(),region.end(),address,[](ptr32_t a, const Region& r){
+    return a<r.address;
+    });
+  if(it==region.begin())
+    return nullptr;
+  --it;
+  if(address-it->address>=it->size)
+    return nullptr;
+  lastHit = size_t(std::distance(region.begin(),it));
+  return &(*it);
   }
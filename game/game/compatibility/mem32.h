@@ -40,5 +40,6 @@ class Mem32 {
     void     compactage();
 
     std::vector<Region> region;
+    size_t              lastHit = 0;
   };
 
@@ -398,6 +398,24 @@ void GameScript::initDialogs() {
   vm.enumerate_instances_by_class_name("C_INFO", [this](phoenix::symbol& sym){
     dialogsInfo.push_back(vm.init_instance<phoenix::c_info>(&sym));
     });
+
+  // bucket infos by owner, so dialog lookup doesn't have to walk over every info in game
+  dialogsByNpc.clear();
+  for(auto& info:dialogsInfo) {
+    DlgInfo d;
+    d.info   = info.get();
+    d.symbol = info->symbol_index();
+    if(info->condition!=0)
+      d.condition = vm.find_symbol_by_index(uint32_t(info->condition));
+    dialogsByNpc[info->npc].push_back(d);
+    }
+  }
+
+auto GameScript::npcDialogs(const phoenix::c_npc& npc) const -> const std::vector<DlgInfo>* {
+  auto it = dialogsByNpc.find(int32_t(npc.symbol_index()));
+  if(it==dialogsByNpc.end())
+    return nullptr;
+  return &it->second;
   }
 
 void GameScript::loadDialogOU() {
@@ -406,15 +424,14 @@ void GameScript::loadDialogOU() {
   std::vector<std::string> names = {prefix + ".DAT", prefix + ".BIN"};
 
   for(auto OU:names) {
-    if(Resources::hasFile(OU)) {
-      auto buf = Resources::getFileBuffer(OU);
+    auto buf = phoenix::buffer::empty();
+    if(Resources::getFileView(OU,buf)) {
       dialogs = phoenix::messages::parse(buf);
       return;
       }
 
     const size_t segment = OU.find_last_of("\\/");
-    if(segment!=std::string::npos && Resources::hasFile(OU.substr(segment+1))) {
-      auto buf = Resources::getFileBuffer(OU.substr(segment+1));
+    if(segment!=std::string::npos && Resources::getFileView(OU.substr(segment+1),buf)) {
       dialogs = phoenix::messages::parse(buf);
       return;
       }
@@ -768,21 +785,18 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<pho
                                                                bool includeImp) {
   ScopeVar self (*vm.global_self(),  hnpc);
   ScopeVar other(*vm.global_other(), player);
-  std::vector<phoenix::c_info*> hDialog;
-  for(auto& info : dialogsInfo) {
-    if(info->npc==static_cast<int>(hnpc->symbol_index())) {
-      hDialog.push_back(info.get());
-      }
-    }
 
   std::vector<DlgChoice> choice;
+  auto* hDialog = npcDialogs(*hnpc);
+  if(hDialog==nullptr)
+    return choice;
 
   for(int important=includeImp ? 1 : 0;important>=0;--important){
-    for(auto& i:hDialog) {
-      const phoenix::c_info& info = *i;
+    for(auto& dlg:*hDialog) {
+      const phoenix::c_info& info = *dlg.info;
       if(info.important!=important)
         continue;
-      bool npcKnowsInfo = doesNpcKnowInfo(*player,vm.find_symbol_by_instance(info)->index());
+      bool npcKnowsInfo = doesNpcKnowInfo(*player,dlg.symbol);
       if(npcKnowsInfo && !info.permanent)
         continue;
 
@@ -798,19 +812,15 @@ std::vector<GameScript::DlgChoice> GameScript::dialogChoices(std::shared_ptr<pho
         }
 
       bool valid=true;
-      if(info.condition) {
-        auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info.condition));
-        if (conditionSymbol != nullptr) {
-          valid = vm.call_function<int>(conditionSymbol) != 0;
-          }
-        }
+      if(dlg.condition!=nullptr)
+        valid = vm.call_function<int>(dlg.condition)!=0;
       if(!valid)
         continue;
 
       DlgChoice ch;
       ch.title    = info.description;
       ch.scriptFn = uint32_t(info.information);
-      ch.handle   = i;
+      ch.handle   = dlg.info;
       ch.isTrade  = info.trade!=0;
       ch.sort     = info.nr;
       choice.emplace_back(std::move(ch));
@@ -2254,21 +2264,18 @@ bool GameScript::npc_checkinfo(std::shared_ptr<phoenix::c_npc> npcRef, int imp)
 
   auto& pl  = hero->handle();
   auto& npc = n->handle();
-  for(auto& info:dialogsInfo) {
-    if(info->npc!=int32_t(npc.symbol_index()) || info->important!=imp)
+  auto* hDialog = npcDialogs(npc);
+  if(hDialog==nullptr)
+    return false;
+  for(auto& dlg:*hDialog) {
+    auto& info = *dlg.info;
+    if(info.important!=imp)
       continue;
-    bool npcKnowsInfo = doesNpcKnowInfo(pl,info->symbol_index());
-    if(npcKnowsInfo && !info->permanent)
+    bool npcKnowsInfo = doesNpcKnowInfo(pl,dlg.symbol);
+    if(npcKnowsInfo && !info.permanent)
       continue;
-    bool valid=false;
-    if(info->condition) {
-      auto* conditionSymbol = vm.find_symbol_by_index(uint32_t(info->condition));
-      if (conditionSymbol != nullptr)
-        valid = vm.call_function<int>(conditionSymbol)!=0;
-      }
-    if(valid) {
+    if(dlg.condition!=nullptr && vm.call_function<int>(dlg.condition)!=0)
       return true;
-      }
     }
   return false;
   }
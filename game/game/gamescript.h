@@ -167,6 +167,12 @@ class GameScript final {
       using signature = R(P...);
       };
 
+    struct DlgInfo final {
+      phoenix::c_info* info      = nullptr;
+      phoenix::symbol* condition = nullptr;
+      size_t           symbol    = 0;
+      };
+
     struct GlobalOutput : AiOuputPipe {
       explicit GlobalOutput(GameScript& owner):owner(owner){}
 
@@ -415,6 +421,8 @@ class GameScript final {
 
     void exitsession         ();
 
+    auto npcDialogs(const phoenix::c_npc& npc) const -> const std::vector<DlgInfo>*;
+
     void sort(std::vector<DlgChoice>& dlg);
     void setNpcInfoKnown(const phoenix::c_npc& npc, const phoenix::c_info& info);
     bool doesNpcKnowInfo(const phoenix::c_npc& npc, size_t infoInstance) const;
@@ -436,6 +444,7 @@ class GameScript final {
 
     std::set<std::pair<size_t,size_t>>                          dlgKnownInfos;
     std::vector<std::shared_ptr<phoenix::c_info>>               dialogsInfo;
+    std::unordered_map<int32_t,std::vector<DlgInfo>>            dialogsByNpc;
     phoenix::messages                                           dialogs;
     std::unordered_map<size_t,AiState>                          aiStates;
     std::unique_ptr<AiOuputPipe>                                aiDefaultPipe;
@@ -14,12 +14,32 @@
 #include "serialize.h"
 #include "camera.h"
 #include "gothic.h"
+#include "commandline.h"
+#include "resources.h"
+#include "utils/workers.h"
 
 using namespace Tempest;
 
+static bool sameName(std::string_view a, std::string_view b) {
+  if(a.size()!=b.size())
+    return false;
+  for(size_t i=0; i<a.size(); ++i)
+    if(std::tolower(a[i])!=std::tolower(b[i]))
+      return false;
+  return true;
+  }
+
 // rate 14.5 to 1
 const uint64_t GameSession::multTime=29;
 const uint64_t GameSession::divTime =2;
+// zone triggers re-request preload every second, while player is near
+const uint64_t GameSession::preloadTimeout=3000;
+
+struct GameSession::Preload final {
+  std::string                   name;
+  std::atomic_bool              cancel{false};
+  std::unique_ptr<WorldPreload> result;
+  };
 
 void GameSession::HeroStorage::save(Npc& npc) {
   storage.clear();
@@ -151,6 +171,7 @@ GameSession::GameSession(Serialize &fin) {
   }
 
 GameSession::~GameSession() {
+  dropPreload();
   }
 
 void GameSession::save(Serialize &fout, std::string_view name, const Pixmap& screen) {
@@ -232,6 +253,69 @@ void GameSession::changeWorld(std::string_view world, std::string_view wayPoint)
   chWorld.wp  = wayPoint;
   }
 
+void GameSession::preloadWorld(std::string_view world) {
+  size_t cut = world.rfind('\\');
+  if(cut!=std::string::npos)
+    world = world.substr(cut+1);
+
+  if(wrld!=nullptr && sameName(wrld->name(),world))
+    return;
+  if(preload!=nullptr) {
+    if(sameName(preload->name,world)) {
+      preloadIdle = 0;
+      return;
+      }
+    // only one world in flight
+    if(preloadFut.wait_for(std::chrono::seconds(0))!=std::future_status::ready)
+      return;
+    dropPreload();
+    }
+  if(!Resources::hasFile(world))
+    return;
+
+  preloadIdle   = 0;
+  preload       = std::make_shared<Preload>();
+  preload->name = std::string(world);
+  preloadFut    = std::async(std::launch::async,[p = preload]() {
+    Workers::setThreadName("Preload thread");
+    Workers::setThreadBackground();
+    try {
+      p->result = World::preload(p->name,p->cancel,CommandLine::inst().resourceBudget());
+      }
+    catch(...) {
+      Log::e("unable to preload world: \"",p->name,"\"");
+      }
+    // nobody is going to take it
+    if(p->cancel.load())
+      p->result.reset();
+    });
+  }
+
+auto GameSession::takePreload(std::string_view name) -> std::unique_ptr<WorldPreload> {
+  if(preload==nullptr)
+    return nullptr;
+  if(!sameName(preload->name,name)) {
+    dropPreload();
+    return nullptr;
+    }
+
+  preloadFut.get();
+  auto ret = std::move(preload->result);
+  preload.reset();
+  return ret;
+  }
+
+void GameSession::dropPreload() {
+  if(preload==nullptr)
+    return;
+  preload->cancel.store(true);
+  preload.reset();
+  // parser can't be interrupted: let the job run out in background, instead of waiting for it here
+  if(preloadFut.valid() && preloadFut.wait_for(std::chrono::seconds(0))!=std::future_status::ready)
+    Gothic::inst().detachJob(std::move(preloadFut));
+  preloadFut = std::future<void>();
+  }
+
 void GameSession::exitSession() {
   exitSessionFlg=true;
   }
@@ -281,6 +365,12 @@ void GameSession::tick(uint64_t dt) {
   wrld->tick(dt);
   // std::this_thread::sleep_for(std::chrono::milliseconds(60));
 
+  if(preload!=nullptr) {
+    preloadIdle += dt;
+    if(preloadIdle>preloadTimeout)
+      dropPreload();
+    }
+
   if(exitSessionFlg) {
     exitSessionFlg = false;
     Gothic::inst().clearGame();
@@ -327,10 +417,15 @@ auto GameSession::implChangeWorld(std::unique_ptr<GameSession>&& game,
     return std::move(game);
     }
 
+  // wait for background preload before eviction; abandoned ones would keep warming caches
+  auto pre = takePreload(w);
+  Gothic::inst().joinDetachedJobs();
+
   HeroStorage hdata;
   if(auto hero = wrld->player())
     hdata.save(*hero);
   clearWorld();
+  Resources::evictUnused(CommandLine::inst().resourceBudget());
 
   vm->resetVarPointers();
 
@@ -343,7 +438,7 @@ auto GameSession::implChangeWorld(std::unique_ptr<GameSession>&& game,
     Gothic::inst().setLoadingProgress(v);
     };
 
-  std::unique_ptr<World> ret = std::unique_ptr<World>(new World(*this,w,wss.isEmpty(),loadProgress));
+  std::unique_ptr<World> ret = std::unique_ptr<World>(new World(*this,w,wss.isEmpty(),loadProgress,std::move(pre)));
   setWorld(std::move(ret));
 
   if(!wss.isEmpty()) {
@@ -3,6 +3,8 @@
 #include <Tempest/Sound>
 #include <Tempest/SoundDevice>
 #include <memory>
+#include <future>
+#include <atomic>
 
 #include "ui/documentmenu.h"
 #include "ui/chapterscreen.h"
@@ -22,6 +24,7 @@ class VisualFx;
 class WorldStateStorage;
 class VersionInfo;
 class GthFont;
+struct WorldPreload;
 
 class GameSession final {
   public:
@@ -38,6 +41,7 @@ class GameSession final {
     auto         clearWorld() -> std::unique_ptr<World>;
 
     void         changeWorld(std::string_view world, std::string_view wayPoint);
+    void         preloadWorld(std::string_view world);
     void         exitSession();
 
     auto         version() const -> const VersionInfo&;
@@ -78,6 +82,8 @@ class GameSession final {
       std::string zen, wp;
       };
 
+    struct Preload;
+
     struct HeroStorage {
       void                 save(Npc& npc);
       void                 putToWorld(World &owner, std::string_view wayPoint) const;
@@ -89,6 +95,8 @@ class GameSession final {
     void         initScripts(bool firstTime);
     auto         implChangeWorld(std::unique_ptr<GameSession> &&game, std::string_view world, std::string_view wayPoint) -> std::unique_ptr<GameSession>;
     auto         findStorage(std::string_view name) -> const WorldStateStorage&;
+    auto         takePreload(std::string_view name) -> std::unique_ptr<WorldPreload>;
+    void         dropPreload();
 
     Tempest::SoundDevice           sound;
 
@@ -104,6 +112,11 @@ class GameSession final {
     ChWorld                        chWorld;
     bool                           exitSessionFlg=false;
 
+    std::shared_ptr<Preload>       preload;
+    std::future<void>              preloadFut;
+    uint64_t                       preloadIdle=0;
+
     static const uint64_t          multTime;
     static const uint64_t          divTime;
+    static const uint64_t          preloadTimeout;
   };
@@ -96,6 +96,7 @@ void Inventory::implLoad(Npc* owner, World& world, Serialize &s) {
   s.read(sz);
   for(size_t i=0;i<sz;++i)
     items.emplace_back(std::make_unique<Item>(world,s,Item::T_Inventory));
+  rebuildIndex();
 
   s.read(sz);
   mdlSlots.resize(sz);
@@ -192,16 +193,14 @@ Inventory::Iterator Inventory::iterator(IteratorType t) const {
   }
 
 int32_t Inventory::priceOf(size_t cls) const {
-  for(auto& i:items)
-    if(i->clsId()==cls)
-      return i->cost();
+  if(auto it = findByClass(cls))
+    return it->cost();
   return 0;
   }
 
 int32_t Inventory::sellPriceOf(size_t cls) const {
-  for(auto& i:items)
-    if(i->clsId()==cls)
-      return i->sellCost();
+  if(auto it = findByClass(cls))
+    return it->sellCost();
   return 0;
   }
 
@@ -213,9 +212,8 @@ size_t Inventory::goldCount() const {
   }
 
 size_t Inventory::itemCount(const size_t cls) const {
-  for(auto& i:items)
-    if(i->clsId()==cls)
-      return i->count();
+  if(auto it = findByClass(cls))
+    return it->count();
   return 0;
   }
 
@@ -230,6 +228,7 @@ Item* Inventory::addItem(std::unique_ptr<Item> &&p) {
   if(it==nullptr) {
     p->clearView();
     items.emplace_back(std::move(p));
+    byClass[cls] = items.back().get();
     return items.back().get();
     } else {
     it->setCount(it->count()+p->count());
@@ -258,6 +257,7 @@ Item* Inventory::addItem(size_t itemSymbol, size_t count, World &owner) {
       std::unique_ptr<Item> ptr{new Item(owner,itemSymbol,Item::T_Inventory)};
       ptr->setCount(count);
       items.emplace_back(std::move(ptr));
+      byClass[itemSymbol] = items.back().get();
       return items.back().get();
       }
     catch(const std::runtime_error& call) {
@@ -301,39 +301,46 @@ void Inventory::delItem(Item *it, size_t count, Npc& owner) {
       }
   sorted=false;
 
+  const size_t cls = it->clsId();
   for(size_t i=0;i<items.size();++i)
-    if(items[i]->clsId()==it->clsId()){
+    if(items[i].get()==it){
       items.erase(items.begin()+int(i));
       break;
       }
+  reindexClass(cls);
   }
 
 void Inventory::transfer(Inventory &to, Inventory &from, Npc* fromNpc, size_t itemSymbol, size_t count, World &wrld) {
-  for(size_t i=0;i<from.items.size();++i){
-    auto& it = *from.items[i];
-    if(it.clsId()!=itemSymbol)
-      continue;
+  Item* ptr = from.findByClass(itemSymbol);
+  if(ptr==nullptr)
+    return;
 
-    from.sorted = false;
-    to.sorted   = false;
+  auto& it = *ptr;
+  from.sorted = false;
+  to.sorted   = false;
 
-    if(count>it.count())
-      count=it.count();
+  if(count>it.count())
+    count=it.count();
 
-    if(it.count()==count) {
-      if(it.isEquipped()) {
-        if(fromNpc==nullptr){
-          Log::e("Inventory: invalid transfer call");
-          return; // error
-          }
-        from.unequip(&it,*fromNpc);
+  if(it.count()==count) {
+    if(it.isEquipped()) {
+      if(fromNpc==nullptr){
+        Log::e("Inventory: invalid transfer call");
+        return; // error
         }
+      from.unequip(&it,*fromNpc);
+      }
+    for(size_t i=0;i<from.items.size();++i) {
+      if(from.items[i].get()!=ptr)
+        continue;
       to.addItem(std::move(from.items[i]));
       from.items.erase(from.items.begin()+int(i));
-      } else {
-      it.setCount(it.count()-count);
-      to.addItem(itemSymbol,count,wrld);
+      from.reindexClass(itemSymbol);
+      break;
       }
+    } else {
+    it.setCount(it.count()-count);
+    to.addItem(itemSymbol,count,wrld);
     }
   }
 
@@ -564,6 +571,7 @@ void Inventory::clear(GameScript&, Npc&, bool includeMissionItm) {
       used.emplace_back(std::move(i));
       }
   items = std::move(used); // Gothic don't clear items, which are in use
+  rebuildIndex();
   }
 
 void Inventory::clear(GameScript& vm, Interactive& owner, bool includeMissionItm) {
@@ -573,6 +581,7 @@ void Inventory::clear(GameScript& vm, Interactive& owner, bool includeMissionItm
       used.emplace_back(std::move(i));
       }
   items = std::move(used); // Gothic don't clear items, which are in use
+  rebuildIndex();
   }
 
 bool Inventory::hasSpell(int32_t splId) const {
@@ -600,9 +609,8 @@ bool Inventory::hasRangedWeaponWithAmmo() const {
   for(auto& i:items) {
     uint32_t cls = uint32_t(i->handle().munition);
     if(cls>0 && cls!=munition) {
-      for(auto& it:items)
-        if(it->clsId()==cls)
-          return true;
+      if(findByClass(cls)!=nullptr)
+        return true;
       munition = cls;
       }
     }
@@ -934,10 +942,34 @@ void Inventory::equipBestArmour(Npc &owner) {
   }
 
 Item *Inventory::findByClass(size_t cls) {
+  auto it = byClass.find(cls);
+  if(it==byClass.end())
+    return nullptr;
+  return it->second;
+  }
+
+const Item* Inventory::findByClass(size_t cls) const {
+  auto it = byClass.find(cls);
+  if(it==byClass.end())
+    return nullptr;
+  return it->second;
+  }
+
+void Inventory::rebuildIndex() {
+  byClass.clear();
+  byClass.reserve(items.size());
   for(auto& i:items)
-    if(i->clsId()==cls)
-      return i.get();
-  return nullptr;
+    byClass.emplace(i->clsId(),i.get()); // first entry wins, same as linear search
+  }
+
+void Inventory::reindexClass(size_t cls) {
+  // another stack of same class may remain (see rebuildIndex)
+  for(auto& i:items)
+    if(i->clsId()==cls) {
+      byClass[cls] = i.get();
+      return;
+      }
+  byClass.erase(cls);
   }
 
 Item* Inventory::bestItem(Npc &owner, ItmFlags f) {
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <string_view>
 #include <string>
 
@@ -135,6 +136,9 @@ class Inventory final {
     void   applyArmour (Item& it, Npc &owner, int32_t sgn);
 
     Item*  findByClass(size_t cls);
+    const Item* findByClass(size_t cls) const;
+    void   rebuildIndex();
+    void   reindexClass(size_t cls);
     void   delItem    (Item* it, size_t count, Npc& owner);
     void   invalidateCond(Item*& slot,  Npc &owner);
 
@@ -152,6 +156,7 @@ class Inventory final {
 
     mutable std::vector<std::unique_ptr<Item>> items;
     mutable bool                               sorted=false;
+    std::unordered_map<size_t,Item*>           byClass;
 
     uint32_t                           indexOf(const Item* it) const;
     Item*                              readPtr(Serialize& fin);
@@ -995,7 +995,10 @@ void MoveAlgo::onGravityFailed(const DynamicWorld::CollisionTest& info, uint64_t
 float MoveAlgo::waterRay(const Tempest::Vec3& p, bool* hasCol) const {
   auto pos = p - Tempest::Vec3(0,waterPadd,0);
   if(std::fabs(cacheW.x-pos.x)>eps || std::fabs(cacheW.y-pos.y)>eps || std::fabs(cacheW.z-pos.z)>eps) {
-    static_cast<DynamicWorld::RayWaterResult&>(cacheW) = npc.world().physic()->waterRay(pos);
+    auto& physic = *npc.world().physic();
+    if(npc.processPolicy()==Npc::AiNormal && !npc.isPlayer())
+      static_cast<DynamicWorld::RayWaterResult&>(cacheW) = physic.waterRayCached(pos); else
+      static_cast<DynamicWorld::RayWaterResult&>(cacheW) = physic.waterRay(pos);
     cacheW.x = pos.x;
     cacheW.y = pos.y;
     cacheW.z = pos.z;
@@ -1010,7 +1013,11 @@ void MoveAlgo::rayMain(const Tempest::Vec3& pos) const {
     float dy = waterDepthChest()+100;  // 1 meter extra offset
     if(fallSpeed.y<0)
       dy = 0; // whole world
-    static_cast<DynamicWorld::RayLandResult&>(cache) = npc.world().physic()->landRay(pos,dy);
+    // npc's share probes via world-level cache; player always does exact ray-test
+    auto& physic = *npc.world().physic();
+    if(npc.processPolicy()==Npc::AiNormal && !npc.isPlayer())
+      static_cast<DynamicWorld::RayLandResult&>(cache) = physic.landRayCached(pos,dy); else
+      static_cast<DynamicWorld::RayLandResult&>(cache) = physic.landRay(pos,dy);
     cache.x = pos.x;
     cache.y = pos.y;
     cache.z = pos.z;
@@ -3,6 +3,7 @@
 #include <Tempest/Log>
 #include <Tempest/TextCodec>
 
+#include <algorithm>
 #include <cstring>
 #include <cctype>
 
@@ -166,6 +167,13 @@ Gothic::Gothic() {
   }
 
 Gothic::~Gothic() {
+  // sessions can hand over jobs on destruction
+  pendingGame.reset();
+  game.reset();
+  {
+  std::lock_guard<std::mutex> guard(syncJobs);
+  detachedJobs.clear();
+  }
   instance = nullptr;
   }
 
@@ -489,7 +497,30 @@ void Gothic::cancelLoading() {
     }
   }
 
+void Gothic::detachJob(std::future<void>&& job) {
+  std::lock_guard<std::mutex> guard(syncJobs);
+  detachedJobs.emplace_back(std::move(job));
+  }
+
+void Gothic::joinDetachedJobs() {
+  std::vector<std::future<void>> jobs;
+  {
+  std::lock_guard<std::mutex> guard(syncJobs);
+  jobs = std::move(detachedJobs);
+  detachedJobs.clear();
+  }
+  for(auto& i:jobs)
+    i.wait();
+  }
+
 void Gothic::tick(uint64_t dt) {
+  {
+  std::lock_guard<std::mutex> guard(syncJobs);
+  detachedJobs.erase(std::remove_if(detachedJobs.begin(),detachedJobs.end(),[](const std::future<void>& f){
+    return f.wait_for(std::chrono::seconds(0))==std::future_status::ready;
+    }),detachedJobs.end());
+  }
+
   if(pendingChapter){
     if(aiIsDlgFinished()) {
       onIntroChapter(chapter);
@@ -604,23 +635,20 @@ std::unique_ptr<phoenix::vm> Gothic::createPhoenixVm(std::string_view datFile) {
   }
 
 phoenix::script Gothic::loadScript(std::string_view datFile) {
-  if(Resources::hasFile(datFile)) {
-    auto buf = Resources::getFileBuffer(datFile);
+  auto buf = phoenix::buffer::empty();
+  if(Resources::getFileView(datFile,buf))
     return phoenix::script::parse(buf);
-    }
 
   const size_t segment = datFile.find_last_of("\\/");
-  if(segment!=std::string::npos && Resources::hasFile(datFile.substr(segment+1))) {
-    auto buf = Resources::getFileBuffer(datFile.substr(segment+1));
+  if(segment!=std::string::npos && Resources::getFileView(datFile.substr(segment+1),buf))
     return phoenix::script::parse(buf);
-    }
 
   auto gscript = CommandLine::inst().scriptPath();
   char16_t str16[256] = {};
   for(size_t i=0; i<datFile.size() && i<255; ++i)
     str16[i] = char16_t(datFile[i]);
   auto path = caseInsensitiveSegment(gscript,str16,Dir::FT_File);
-  auto buf = phoenix::buffer::mmap(path);
+  buf = phoenix::buffer::mmap(path);
   return phoenix::script::parse(buf);
   }
 
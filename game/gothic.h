@@ -3,6 +3,8 @@
 #include <string>
 #include <memory>
 #include <thread>
+#include <future>
+#include <mutex>
 
 #include <Tempest/Signal>
 #include <Tempest/Dir>
@@ -110,6 +112,9 @@ class Gothic final {
     void         startLoad(std::string_view banner, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
     void         startSave(Tempest::Texture2d&& tex, const std::function<std::unique_ptr<GameSession>(std::unique_ptr<GameSession>&&)> f);
     void         cancelLoading();
+    // keeps abandoned background job alive until it is done; pending jobs are waited for on shutdown
+    void         detachJob(std::future<void>&& job);
+    void         joinDetachedJobs();
 
     void         tick(uint64_t dt);
 
@@ -191,6 +196,9 @@ class Gothic final {
     std::thread                             loaderTh;
     std::atomic<LoadState>                  loadingFlag{LoadState::Idle};
 
+    std::mutex                              syncJobs;
+    std::vector<std::future<void>>          detachedJobs;
+
     std::unique_ptr<GameSession>            game, pendingGame;
     std::unique_ptr<FightAi>                fight;
     std::unique_ptr<CameraDefinitions>      camDef;
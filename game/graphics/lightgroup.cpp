@@ -3,6 +3,7 @@
 #include <Tempest/Dir>
 #include <Tempest/Log>
 
+#include "graphics/dynamic/frustrum.h"
 #include "graphics/shaders.h"
 #include "graphics/sceneglobals.h"
 #include "utils/string_frm.h"
@@ -13,31 +14,73 @@
 using namespace Tempest;
 
 size_t LightGroup::LightBucket::alloc() {
-  for(auto& i:updated)
-    i = false;
-  if(freeList.size()>0) {
-    auto ret = freeList.back();
-    freeList.pop_back();
-    return ret;
-    }
-  data.emplace_back();
-  light.emplace_back();
-  return data.size()-1;
+  invalidate();
+  return list.alloc();
   }
 
 void LightGroup::LightBucket::free(size_t id) {
+  invalidate();
+  list.free(id);
+  }
+
+void LightGroup::LightBucket::invalidate() {
   for(auto& i:updated)
     i = false;
-  if(id+1==data.size()) {
-    data.pop_back();
-    light.pop_back();
-    } else {
-    light[id].setRange(0);
-    data[id] = LightSsbo();
-    freeList.push_back(id);
+  }
+
+void LightGroup::LightBucket::markDirty(size_t id) {
+  markDirty(id,id+1);
+  }
+
+void LightGroup::LightBucket::markDirty(size_t begin, size_t end) {
+  for(size_t i=0; i<Resources::MaxFramesInFlight; ++i) {
+    if(dirtyBegin[i]==dirtyEnd[i]) {
+      dirtyBegin[i] = begin;
+      dirtyEnd  [i] = end;
+      } else {
+      dirtyBegin[i] = std::min(dirtyBegin[i],begin);
+      dirtyEnd  [i] = std::max(dirtyEnd  [i],end);
+      }
     }
   }
 
+void LightGroup::LightBucket::upload(uint8_t fId) {
+  auto& device = Resources::device();
+  auto& data   = list.data;
+  const size_t begin = dirtyBegin[fId];
+  const size_t end   = std::min(dirtyEnd[fId],data.size());
+  dirtyBegin[fId] = 0;
+  dirtyEnd  [fId] = 0;
+
+  if(!updated[fId]) {
+    updated[fId] = true;
+    if(ssbo[fId].byteSize()==data.size()*sizeof(data[0])) {
+      ssbo[fId].update(data);
+      } else {
+      ssbo[fId] = device.ssbo(BufferHeap::Upload,data);
+      ubo [fId].set(4,ssbo[fId]);
+      }
+    return;
+    }
+
+  if(begin<end)
+    ssbo[fId].update(data.data()+begin, begin*sizeof(data[0]), (end-begin)*sizeof(data[0]));
+  }
+
+void LightGroup::LightBucket::updateVisibility(const Frustrum& fr, uint8_t fId) {
+  // instances are drawn through compact index list; precise per-light test is done in vertex shader
+  auto& vis = visible[fId];
+  list.cull(fr,vis);
+  if(vis.empty())
+    return;
+
+  auto& device = Resources::device();
+  if(visSsbo[fId].byteSize()<vis.size()*sizeof(vis[0])) {
+    visSsbo[fId] = device.ssbo(BufferHeap::Upload,nullptr,std::max(vis.capacity(),list.size())*sizeof(vis[0]));
+    ubo    [fId].set(11,visSsbo[fId]);
+    }
+  visSsbo[fId].update(vis.data(),0,vis.size()*sizeof(vis[0]));
+  }
 
 LightGroup::Light::Light(LightGroup::Light&& oth):owner(oth.owner), id(oth.id) {
   oth.owner = nullptr;
@@ -243,7 +286,7 @@ void LightGroup::dbgLights(DbgPainter& p) const {
 
   const LightBucket* bucket[2] = {&bucketSt, &bucketDyn};
   for(auto b:bucket) {
-    for(auto& i:b->light) {
+    for(auto& i:b->list.light) {
       auto pt = i.position();
       float l = 10;
       p.drawLine(pt-Vec3(l,0,0),pt+Vec3(l,0,0));
@@ -314,21 +357,19 @@ void LightGroup::free(size_t id) {
 
 LightGroup::LightSsbo& LightGroup::get(size_t id) {
   if(id & staticMask) {
-    for(auto& i:bucketSt.updated)
-      i = false;
-    return bucketSt.data[id^staticMask];
+    bucketSt.markDirty(id^staticMask);
+    return bucketSt.list.data[id^staticMask];
     }
 
-  for(auto& i:bucketDyn.updated)
-    i = false;
-  return bucketDyn.data[id];
+  bucketDyn.markDirty(id);
+  return bucketDyn.list.data[id];
   }
 
 LightSource& LightGroup::getL(size_t id) {
   if(id & staticMask) {
-    return bucketSt.light[id^staticMask];
+    return bucketSt.list.light[id^staticMask];
     }
-  return bucketDyn.light[id];
+  return bucketDyn.list.light[id];
   }
 
 RenderPipeline& LightGroup::shader() const {
@@ -349,38 +390,21 @@ const phoenix::vobs::light_preset& LightGroup::findPreset(std::string_view prese
   }
 
 void LightGroup::tick(uint64_t time) {
-  for(size_t i=0; i<bucketDyn.light.size(); ++i) {
-    auto& light = bucketDyn.light[i];
-    light.update(time);
-
-    auto& ssbo = bucketDyn.data[i];
-    ssbo.pos   = light.position();
-    ssbo.color = light.currentColor();
-    ssbo.range = light.currentRange();
-
-    for(auto& updated:bucketDyn.updated)
-      updated = false;
-    }
+  size_t begin = 0, end = 0;
+  if(bucketDyn.list.tick(time,begin,end))
+    bucketDyn.markDirty(begin,end);
   }
 
 void LightGroup::preFrameUpdate(uint8_t fId) {
-  auto& device = Resources::device();
+  Frustrum fr;
+  fr.make(scene.viewProject(),1,1);
+
   LightBucket* bucket[2] = {&bucketSt, &bucketDyn};
   for(auto b:bucket) {
-    if(b->updated[fId])
-      continue;
-    b->updated[fId] = true;
-    if(b->ssbo[fId].byteSize()==b->data.size()*sizeof(b->data[0])) {
-      b->ssbo[fId].update(b->data);
-      } else {
-      b->ssbo[fId] = device.ssbo(BufferHeap::Upload,b->data);
-      b->ubo [fId].set(4,b->ssbo[fId]);
-      }
+    b->upload(fId);
+    b->updateVisibility(fr,fId);
     }
 
-  Frustrum fr;
-  fr.make(scene.viewProject(),1,1);
-
   Ubo ubo;
   ubo.mvp       = scene.viewProject();
   ubo.mvpLwcInv = scene.viewProjectLwcInv();
@@ -398,13 +422,13 @@ void LightGroup::draw(Encoder<CommandBuffer>& cmd, uint8_t fId) {
     return;
 
   auto& p = shader();
-  if(bucketSt.data.size()>0) {
-    cmd.setUniforms(p,bucketSt.ubo[fId]);
-    cmd.draw(vbo,ibo, 0,ibo.size(), 0,bucketSt.data.size());
-    }
-  if(bucketDyn.data.size()>0) {
-    cmd.setUniforms(p,bucketDyn.ubo[fId]);
-    cmd.draw(vbo,ibo, 0,ibo.size(), 0,bucketDyn.data.size());
+  LightBucket* bucket[2] = {&bucketSt, &bucketDyn};
+  for(auto b:bucket) {
+    const size_t count = b->visible[fId].size();
+    if(count==0)
+      continue;
+    cmd.setUniforms(p,b->ubo[fId]);
+    cmd.draw(vbo,ibo, 0,ibo.size(), 0,count);
     }
   }
 
@@ -4,10 +4,11 @@
 #include <phoenix/vobs/light.hh>
 #include <memory>
 
-#include "lightsource.h"
+#include "lightlist.h"
 #include "resources.h"
 
 class DbgPainter;
+class Frustrum;
 class SceneGlobals;
 class World;
 
@@ -71,24 +72,26 @@ class LightGroup final {
       Tempest::Vec3      origin;
       };
 
-    struct LightSsbo {
-      Tempest::Vec3 pos;
-      float         range  = 0;
-      Tempest::Vec3 color;
-      float         pading = 0;
-      };
+    using LightSsbo = LightList::LightSsbo;
 
     struct LightBucket {
-      std::vector<LightSource> light;
-      std::vector<LightSsbo>   data;
+      LightList                list;
       Tempest::StorageBuffer   ssbo[Resources::MaxFramesInFlight];
       bool                     updated[Resources::MaxFramesInFlight] = {};
+      size_t                   dirtyBegin[Resources::MaxFramesInFlight] = {};
+      size_t                   dirtyEnd  [Resources::MaxFramesInFlight] = {};
+      std::vector<uint32_t>    visible   [Resources::MaxFramesInFlight];
+      Tempest::StorageBuffer   visSsbo   [Resources::MaxFramesInFlight];
 
-      std::vector<size_t>      freeList;
       Tempest::DescriptorSet   ubo[Resources::MaxFramesInFlight];
 
       size_t                   alloc();
       void                     free(size_t id);
+      void                     invalidate();
+      void                     markDirty(size_t id);
+      void                     markDirty(size_t begin, size_t end);
+      void                     upload(uint8_t fId);
+      void                     updateVisibility(const Frustrum& fr, uint8_t fId);
       };
 
     size_t                             alloc(bool dynamic);
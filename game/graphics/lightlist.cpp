@@ -0,0 +1,68 @@
+#include "lightlist.h"
+
+#include "graphics/dynamic/frustrum.h"
+#include "utils/workers.h"
+
+using namespace Tempest;
+
+size_t LightList::alloc() {
+  if(freeList.size()>0) {
+    auto ret = freeList.back();
+    freeList.pop_back();
+    return ret;
+    }
+  data.emplace_back();
+  light.emplace_back();
+  return data.size()-1;
+  }
+
+void LightList::free(size_t id) {
+  if(id+1==data.size()) {
+    data.pop_back();
+    light.pop_back();
+    } else {
+    light[id].setRange(0);
+    data[id] = LightSsbo();
+    freeList.push_back(id);
+    }
+  }
+
+bool LightList::tick(uint64_t time, size_t& begin, size_t& end) {
+  begin = data.size();
+  end   = 0;
+  for(size_t i=0; i<light.size(); ++i) {
+    auto& l = light[i];
+    if(!l.isDynamic())
+      continue;
+    l.update(time);
+
+    auto& ssbo = data[i];
+    if(ssbo.color==l.currentColor() && ssbo.range==l.currentRange())
+      continue;
+    ssbo.color = l.currentColor();
+    ssbo.range = l.currentRange();
+    begin = std::min(begin,i);
+    end   = i+1;
+    }
+  return begin<end;
+  }
+
+void LightList::cull(const Frustrum& fr, std::vector<uint32_t>& visible) {
+  const size_t count = (data.size()+CHUNK_SIZE-1)/CHUNK_SIZE;
+  chunks.resize(count);
+  Workers::parallelFor(chunks,[this,&fr](std::vector<uint32_t>& chunk) {
+    const size_t b = size_t(&chunk-chunks.data())*CHUNK_SIZE;
+    const size_t e = std::min(b+CHUNK_SIZE,data.size());
+    chunk.clear();
+    for(size_t i=b; i<e; ++i) {
+      auto& l = data[i];
+      if(l.range<=0 || !fr.testPoint(l.pos,l.range))
+        continue;
+      chunk.push_back(uint32_t(i));
+      }
+    });
+
+  visible.clear();
+  for(auto& c:chunks)
+    visible.insert(visible.end(),c.begin(),c.end());
+  }
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "lightsource.h"
+
+class Frustrum;
+
+// CPU side of a LightGroup bucket: light state, its gpu-side copy and per-frame culling
+class LightList final {
+  public:
+    struct LightSsbo {
+      Tempest::Vec3 pos;
+      float         range  = 0;
+      Tempest::Vec3 color;
+      float         pading = 0;
+      };
+
+    size_t  alloc();
+    void    free(size_t id);
+    size_t  size() const { return data.size(); }
+
+    // re-evaluates animated lights; returns false, if no ssbo entry changed, otherwise [begin,end) covers all changes
+    bool    tick(uint64_t time, size_t& begin, size_t& end);
+    // compact list of lights, that intersect the frustum; ascending order, chunks are culled on workers
+    void    cull(const Frustrum& fr, std::vector<uint32_t>& visible);
+
+    std::vector<LightSource> light;
+    std::vector<LightSsbo>   data;
+
+  private:
+    enum {
+      CHUNK_SIZE = 256
+      };
+
+    std::vector<size_t>                freeList;
+    std::vector<std::vector<uint32_t>> chunks;
+  };
@@ -11,11 +11,12 @@ static Tempest::Color toColor(glm::u8vec4 v) {
   }
 
 Material::Material(const phoenix::material& m, bool enableAlphaTest) {
-  tex = Resources::loadTexture(m.texture);
+  // mesh materials: textures are kept alive by resident meshes, see Resources::evictUnused
+  tex = Resources::loadTexture(m.texture,true);
   if(tex==nullptr) {
     if(!m.texture.empty())
-      tex = Resources::loadTexture("DEFAULT.TGA"); else
-      tex = Resources::loadTexture(toColor(m.color));
+      tex = Resources::loadTexture("DEFAULT.TGA",true); else
+      tex = Resources::loadTexture(toColor(m.color),true);
     }
 
   loadFrames(m);
@@ -42,11 +43,11 @@ Material::Material(const phoenix::material& m, bool enableAlphaTest) {
   }
 
 Material::Material(const phoenix::vob& vob) {
-  tex = Resources::loadTexture(vob.visual_name);
+  tex = Resources::loadTexture(vob.visual_name,true);
   if(tex==nullptr && !vob.visual_name.empty())
-    tex = Resources::loadTexture("DEFAULT.TGA");
+    tex = Resources::loadTexture("DEFAULT.TGA",true);
 
-  frames       = Resources::loadTextureAnim(vob.visual_name);
+  frames       = Resources::loadTextureAnim(vob.visual_name,true);
 
   texAniFPSInv = 1000/std::max<size_t>(frames.size(),1);
   alpha        = loadAlphaFunc(vob.visual_decal->alpha_func,phoenix::material_group::undefined,vob.visual_decal->alpha_weight,tex,true);
@@ -165,7 +166,7 @@ Material::AlphaFunc Material::loadAlphaFunc(phoenix::alpha_function zenAlpha,
   }
 
 void Material::loadFrames(const phoenix::material& m) {
-  frames = Resources::loadTextureAnim(m.texture);
+  frames = Resources::loadTextureAnim(m.texture,true);
   if(m.texture_anim_fps > 0)
     texAniFPSInv = uint64_t(1.0f / m.texture_anim_fps); else
     texAniFPSInv = 1;
@@ -107,6 +107,18 @@ std::string_view Animation::defaultMesh() const {
   return "";
   }
 
+size_t Animation::memoryUsage() const {
+  size_t ret = sizeof(*this) + sequences.size()*sizeof(Sequence);
+  for(auto& i:sequences) {
+    if(i.data==nullptr)
+      continue;
+    ret += i.data->samples.size()  *sizeof(phoenix::animation_sample);
+    ret += i.data->nodeIndex.size()*sizeof(uint32_t);
+    ret += i.data->tr.size()       *sizeof(Tempest::Vec3);
+    }
+  return ret;
+  }
+
 Animation::Sequence& Animation::loadMAN(const phoenix::mds::animation& hdr, std::string_view name) {
   sequences.emplace_back(hdr,name);
   auto& ret = sequences.back();
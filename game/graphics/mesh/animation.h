@@ -124,6 +124,7 @@ class Animation final {
     const Sequence*    sequenceAsc(std::string_view name) const;
     void               debug() const;
     std::string_view   defaultMesh() const;
+    size_t             memoryUsage() const;
 
   private:
     Sequence&          loadMAN(const phoenix::mds::animation& hdr, std::string_view name);
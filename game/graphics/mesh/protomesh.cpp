@@ -319,6 +319,17 @@ size_t ProtoMesh::skinedNodesCount() const {
   return ret;
   }
 
+size_t ProtoMesh::memoryUsage() const {
+  size_t ret = sizeof(*this);
+  for(auto& i:attach)
+    ret += i.vbo.size()*sizeof(StaticMesh::Vertex) + i.ibo.size()*sizeof(uint32_t) + i.ibo8.byteSize();
+  for(auto& i:skined)
+    ret += i.vbo.size()*sizeof(Vertex) + i.ibo.size()*sizeof(uint32_t) + i.ibo8.byteSize();
+  ret += morphIndex.byteSize() + morphSamples.byteSize();
+  ret += nodes.size()*sizeof(Node);
+  return ret;
+  }
+
 Tempest::Matrix4x4 ProtoMesh::mapToRoot(size_t n) const {
   Tempest::Matrix4x4 m;
   m.identity();
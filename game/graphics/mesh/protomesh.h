@@ -88,6 +88,7 @@ class ProtoMesh {
     std::string                    scheme, fname;
 
     size_t                         skinedNodesCount() const;
+    size_t                         memoryUsage() const;
     Tempest::Matrix4x4             mapToRoot(size_t node) const;
     size_t                         findNode(std::string_view name,size_t def=size_t(-1)) const;
 
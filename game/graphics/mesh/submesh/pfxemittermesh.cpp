@@ -54,6 +54,13 @@ PfxEmitterMesh::PfxEmitterMesh(const phoenix::model_mesh& library) {
   mkIndex();
 }
 
+size_t PfxEmitterMesh::memoryUsage() const {
+  return sizeof(*this) +
+         triangle.size()*sizeof(Triangle) +
+         vertices.size()*sizeof(Tempest::Vec3) +
+         vertAnim.size()*sizeof(AnimData);
+  }
+
 Tempest::Vec3 PfxEmitterMesh::randCoord(float rnd, const Pose* pose) const {
   if(triangle.size()==0)
     return Tempest::Vec3();
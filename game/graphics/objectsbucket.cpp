@@ -203,6 +203,34 @@ bool ObjectsBucket::isCompatible(const Type t, const Material& mat,
   return this->mat==mat && instanceDesc==desc && staticMesh==st && animMesh==ani;
   }
 
+size_t ObjectsBucket::compatibilityKey(const Type t, const Material& mat,
+                                       const StaticMesh* st, const AnimMesh* ani,
+                                       const Tempest::StorageBuffer* desc) {
+  // must hash only fields, that are compared by isCompatible
+  auto type = sanitizeType(t,mat,st);
+
+  auto mix = [](size_t h, size_t v) {
+    return h ^ (v + 0x9e3779b9 + (h<<6) + (h>>2));
+    };
+
+  size_t h = size_t(type);
+  if(type==Landscape && Gothic::inst().doMeshShading()) {
+    h = mix(h,size_t(mat.alpha));
+    h = mix(h,std::uintptr_t(desc));
+    return h;
+    }
+
+  h = mix(h,std::uintptr_t(mat.tex));
+  h = mix(h,size_t(mat.alpha));
+  if(type==Pfx || type==Landscape)
+    return h;
+
+  h = mix(h,std::uintptr_t(st));
+  h = mix(h,std::uintptr_t(ani));
+  h = mix(h,std::uintptr_t(desc));
+  return h;
+  }
+
 std::unique_ptr<ObjectsBucket> ObjectsBucket::mkBucket(Type type, const Material& mat, VisualObjects& owner, const SceneGlobals& scene,
                                                        const StaticMesh* st, const AnimMesh* anim, const StorageBuffer* desc) {
   type = sanitizeType(type,mat,st);
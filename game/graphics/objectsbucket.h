@@ -92,6 +92,8 @@ class ObjectsBucket {
 
     bool isCompatible(const Type type, const Material& mat,
                       const StaticMesh* st, const AnimMesh* ani, const Tempest::StorageBuffer* desc) const;
+    static size_t compatibilityKey(const Type type, const Material& mat,
+                                   const StaticMesh* st, const AnimMesh* ani, const Tempest::StorageBuffer* desc);
 
     static std::unique_ptr<ObjectsBucket> mkBucket(Type type, const Material& mat, VisualObjects& owner, const SceneGlobals& scene,
                                                    const StaticMesh* st, const AnimMesh* anim, const Tempest::StorageBuffer* desc);
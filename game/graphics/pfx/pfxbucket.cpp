@@ -23,12 +23,6 @@ static uint64_t ppsDiff(const ParticleFx& decl, bool loop, uint64_t time0, uint6
   return emitted1-emitted0;
   }
 
-float PfxBucket::ParState::lifeTime() const {
-  return 1.f-life/float(maxLife);
-  }
-
-std::mt19937 PfxBucket::rndEngine;
-
 PfxBucket::PfxBucket(const ParticleFx &decl, PfxObjects& parent, VisualObjects& visual)
   :decl(decl), parent(parent), visual(visual)  {
   item = visual.get(decl.visMaterial);
@@ -85,9 +79,6 @@ size_t PfxBucket::allocBlock() {
 
   particles.resize(particles.size()+blockSize);
   pfxCpu   .resize(particles.size());
-
-  for(size_t i=0; i<blockSize; ++i)
-    particles[b.offset+i].life = 0;
   return block.size()-1;
   }
 
@@ -120,7 +111,9 @@ size_t PfxBucket::allocEmitter() {
   for(size_t i=0; i<impl.size(); ++i) {
     auto& b = impl[i];
     if(b.st==S_Free) {
-      b.st = S_Inactive;
+      b.st         = S_Inactive;
+      b.seed       = parent.emitterSeq++;
+      b.rndCounter = 0;
       return i;
       }
     }
@@ -128,6 +121,7 @@ size_t PfxBucket::allocEmitter() {
   auto& e = impl.back();
   e.block = size_t(-1); // no backup memory
   e.st    = S_Inactive;
+  e.seed  = parent.emitterSeq++;
   for(size_t i=0; i<Resources::MaxFramesInFlight; ++i)
     forceUpdate[i] = true;
 
@@ -172,77 +166,80 @@ bool PfxBucket::shrink() {
   return false;
   }
 
-float PfxBucket::randf() {
-  return float(rndEngine()%10000)/10000.f;
+float PfxBucket::randf(ImplEmitter& emitter) {
+  return PfxParticles::rand(emitter.seed,emitter.rndCounter++);
   }
 
-float PfxBucket::randf(float base, float var) {
-  return (2.f*randf()-1.f)*var + base;
+float PfxBucket::randf(ImplEmitter& emitter, float base, float var) {
+  return (2.f*randf(emitter)-1.f)*var + base;
   }
 
 void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t particle) {
-  auto& p   = particles[particle];
+  auto& p    = particles;
+  Vec3  pos  = {};
+  Vec3  dir  = {};
+  auto  life = uint16_t(randf(emitter,decl.lspPartAvg,decl.lspPartVar));
 
-  p.life    = uint16_t(randf(decl.lspPartAvg,decl.lspPartVar));
-  p.maxLife = p.life;
+  p.life   [particle] = life;
+  p.maxLife[particle] = life;
 
   // TODO: pfx.shpDistribType, pfx.shpDistribWalkSpeed;
   switch(decl.shpType) {
     case ParticleFx::EmitterType::Point:{
-      p.pos = Vec3();
+      pos = Vec3();
       break;
       }
     case ParticleFx::EmitterType::Line:{
-      float at = randf();
-      p.pos = Vec3(at,at,at);
+      float at = randf(emitter);
+      pos = Vec3(at,at,at);
       break;
       }
     case ParticleFx::EmitterType::Box:{
       if(decl.shpIsVolume) {
-        p.pos = Vec3(randf()*2.f-1.f,
-                     randf()*2.f-1.f,
-                     randf()*2.f-1.f);
-        p.pos*=0.5;
+        pos = Vec3(randf(emitter)*2.f-1.f,
+                   randf(emitter)*2.f-1.f,
+                   randf(emitter)*2.f-1.f);
+        pos*=0.5;
         } else {
         // TODO
-        p.pos = Vec3(randf()*2.f-1.f,
-                     randf()*2.f-1.f,
-                     randf()*2.f-1.f);
-        p.pos*=0.5;
+        pos = Vec3(randf(emitter)*2.f-1.f,
+                   randf(emitter)*2.f-1.f,
+                   randf(emitter)*2.f-1.f);
+        pos*=0.5;
         }
       break;
       }
     case ParticleFx::EmitterType::Sphere:{
-      float theta = float(2.0*M_PI)*randf();
-      float phi   = std::acos(1.f - 2.f * randf());
-      p.pos = Vec3(std::sin(phi) * std::cos(theta),
-                   std::sin(phi) * std::sin(theta),
-                   std::cos(phi));
-      //p.pos*=0.5;
+      float theta = float(2.0*M_PI)*randf(emitter);
+      float phi   = std::acos(1.f - 2.f * randf(emitter));
+      pos = Vec3(std::sin(phi) * std::cos(theta),
+                 std::sin(phi) * std::sin(theta),
+                 std::cos(phi));
+      //pos*=0.5;
       if(decl.shpIsVolume)
-        p.pos*=randf();
+        pos*=randf(emitter);
       break;
       }
     case ParticleFx::EmitterType::Circle:{
-      float a = float(2.0*M_PI)*randf();
-      p.pos = Vec3(std::sin(a),
-                   0,
-                   std::cos(a));
-      //p.pos*=0.5;
+      float a = float(2.0*M_PI)*randf(emitter);
+      pos = Vec3(std::sin(a),
+                 0,
+                 std::cos(a));
+      //pos*=0.5;
       if(decl.shpIsVolume)
-        p.pos = p.pos*std::sqrt(randf());
+        pos = pos*std::sqrt(randf(emitter));
       break;
       }
     case ParticleFx::EmitterType::Mesh:{
-      p.pos = Vec3();
+      pos = Vec3();
       auto mesh = (emitter.mesh!=nullptr) ? emitter.mesh : decl.shpMesh;
       auto pose = (emitter.mesh!=nullptr) ? emitter.pose : nullptr;
       if(mesh!=nullptr) {
-        auto pos = mesh->randCoord(randf(),pose);
-        pos -= emitter.pos;
-        p.pos = emitter.direction[0]*pos.x +
-                emitter.direction[1]*pos.y +
-                emitter.direction[2]*pos.z;
+        auto at = mesh->randCoord(randf(emitter),pose);
+        at -= emitter.pos;
+        pos = emitter.direction[0]*at.x +
+              emitter.direction[1]*at.y +
+              emitter.direction[2]*at.z;
         }
       break;
       }
@@ -251,34 +248,34 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
   if(decl.shpType!=ParticleFx::EmitterType::Point &&
      decl.shpType!=ParticleFx::EmitterType::Mesh) {
     Vec3 dim = decl.shpDim*decl.shpScale(block.timeTotal);
-    p.pos.x*=dim.x;
-    p.pos.y*=dim.y;
-    p.pos.z*=dim.z;
+    pos.x*=dim.x;
+    pos.y*=dim.y;
+    pos.z*=dim.z;
     }
 
   switch(decl.shpFOR) {
     case ParticleFx::Frame::Object:
     case ParticleFx::Frame::Node: {
-      p.pos += emitter.direction[0]*decl.shpOffsetVec.x +
-               emitter.direction[1]*decl.shpOffsetVec.y +
-               emitter.direction[2]*decl.shpOffsetVec.z;
+      pos += emitter.direction[0]*decl.shpOffsetVec.x +
+             emitter.direction[1]*decl.shpOffsetVec.y +
+             emitter.direction[2]*decl.shpOffsetVec.z;
       break;
       }
     case ParticleFx::Frame::World: {
-      p.pos += decl.shpOffsetVec;
+      pos += decl.shpOffsetVec;
       break;
       }
     }
 
   switch(decl.dirMode) {
     case ParticleFx::Dir::Rand: {
-      float dy    = 1.f - 2.f * randf();
+      float dy    = 1.f - 2.f * randf(emitter);
       float sn    = std::sqrt(1-dy*dy);
-      float theta = float(2.0*M_PI)*randf();
+      float theta = float(2.0*M_PI)*randf(emitter);
       float dx    = sn * std::cos(theta);
       float dz    = sn * std::sin(theta);
 
-      p.dir       = Vec3(dx,dy,dz);
+      dir         = Vec3(dx,dy,dz);
       break;
       }
     case ParticleFx::Dir::Dir: {
@@ -291,8 +288,8 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
       if(decl.dirAngleElevVar>=180 )
         dirAngleElevVar = 0;
 
-      float head = (90+randf(decl.dirAngleHead,dirAngleHeadVar))*float(M_PI)/180.f;
-      float elev = (   randf(decl.dirAngleElev,dirAngleElevVar))*float(M_PI)/180.f;
+      float head = (90+randf(emitter,decl.dirAngleHead,dirAngleHeadVar))*float(M_PI)/180.f;
+      float elev = (   randf(emitter,decl.dirAngleElev,dirAngleElevVar))*float(M_PI)/180.f;
 
       float dx = std::cos(elev) * std::cos(head);
       float dy = std::sin(elev);
@@ -301,13 +298,13 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
       switch(decl.dirFOR) {
         case ParticleFx::Frame::Object:
         case ParticleFx::Frame::Node: {
-          p.dir = emitter.direction[0]*dx +
-                  emitter.direction[1]*dy +
-                  emitter.direction[2]*dz;
+          dir = emitter.direction[0]*dx +
+                emitter.direction[1]*dy +
+                emitter.direction[2]*dz;
           break;
           }
         case ParticleFx::Frame::World: {
-          p.dir = Vec3(dx,dy,dz);
+          dir = Vec3(dx,dy,dz);
           break;
           }
         }
@@ -332,84 +329,105 @@ void PfxBucket::init(PfxBucket::Block& block, ImplEmitter& emitter, size_t parti
           break;
           }
         }
-      p.dir += targetPos - (emitter.pos+p.pos);
+      dir += targetPos - (emitter.pos+pos);
       break;
     }
 
   if(!decl.useEmittersFOR)
-    p.pos += emitter.pos;
+    pos += emitter.pos;
 
-  auto l = p.dir.length();
+  auto l = dir.length();
   if(l!=0.f) {
-    float velocity = randf(decl.velAvg,decl.velVar);
-    p.dir = p.dir*velocity/l;
+    float velocity = randf(emitter,decl.velAvg,decl.velVar);
+    dir = dir*velocity/l;
     }
+
+  p.setPos(particle,pos);
+  p.setDir(particle,dir);
   }
 
 void PfxBucket::finalize(size_t particle) {
-  particles[particle] = {};
-  pfxCpu   [particle] = {};
+  particles.reset(particle);
+  pfxCpu[particle] = {};
   }
 
-void PfxBucket::tick(Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt) {
-  ParState& ps = particles[particle+sys.offset];
-  if(ps.life==0)
-    return;
+void PfxBucket::tick(Block& sys, ImplEmitter& emitter, uint64_t dt) {
+  const size_t begin = sys.offset;
+  const size_t end   = sys.offset+blockSize;
 
-  if(ps.life<=dt){
-    ps.life = 0;
-    sys.count--;
-    finalize(particle+sys.offset);
-    return;
+  for(size_t i=begin; i<end; ++i) {
+    auto& life = particles.life[i];
+    if(life==0)
+      continue;
+    if(life<=dt) {
+      sys.count--;
+      finalize(i);
+      continue;
+      }
+    life = uint16_t(life-dt);
     }
 
-  const float dtF = float(dt);
+  particles.integrate(begin,end,decl.flyGravity,float(dt));
 
-  // eval particle
-  ps.life  = uint16_t(ps.life-dt);
-  ps.pos  += ps.dir*dtF;
-  ps.dir  += decl.flyGravity*dtF;
-
-  if(maxTrlTime!=0)
-    tickTrail(ps,emitter,dt);
+  if(maxTrlTime!=0) {
+    for(size_t i=begin; i<end; ++i)
+      if(particles.life[i]!=0)
+        tickTrail(i,emitter,dt);
+    }
   }
 
-void PfxBucket::tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt) {
-  for(auto& i:ps.trail)
+void PfxBucket::tickTrail(size_t particle, ImplEmitter& emitter, uint64_t dt) {
+  auto& trail = particles.trail[particle];
+  for(auto& i:trail)
     i.time+=dt;
 
   Trail tx;
   if(decl.useEmittersFOR)
-    tx.pos = ps.pos + emitter.pos; else
-    tx.pos = ps.pos;
+    tx.pos = particles.pos(particle) + emitter.pos; else
+    tx.pos = particles.pos(particle);
 
-  if(ps.trail.size()==0) {
-    ps.trail.push_back(tx);
+  if(trail.size()==0) {
+    trail.push_back(tx);
     }
-  else if(ps.trail.back().pos!=tx.pos) {
+  else if(trail.back().pos!=tx.pos) {
     bool extrude = false;
-    if(false && ps.trail.size()>1) {
-      auto u = tx.pos              - ps.trail[ps.trail.size()-2].pos;
-      auto v = ps.trail.back().pos - ps.trail[ps.trail.size()-2].pos;
+    if(false && trail.size()>1) {
+      auto u = tx.pos           - trail[trail.size()-2].pos;
+      auto v = trail.back().pos - trail[trail.size()-2].pos;
       if(std::abs(Vec3::dotProduct(u,v)-u.length()*v.length()) < 0.001f)
         extrude = true;
       }
     if(extrude)
-      ps.trail.back() = tx; else
-      ps.trail.push_back(tx);
+      trail.back() = tx; else
+      trail.push_back(tx);
     }
   else {
-    ps.trail.back().time = 0;
+    trail.back().time = 0;
     }
 
-  for(size_t rm=0; rm<=ps.trail.size(); ++rm) {
-    if(rm==ps.trail.size() || ps.trail[rm].time<maxTrlTime) {
-      ps.trail.erase(ps.trail.begin(),ps.trail.begin()+int(rm));
+  for(size_t rm=0; rm<=trail.size(); ++rm) {
+    if(rm==trail.size() || trail[rm].time<maxTrlTime) {
+      trail.erase(trail.begin(),trail.begin()+int(rm));
       break;
       }
     }
   }
 
+void PfxBucket::tickParticles(uint64_t dt) {
+  if(decl.isDecal())
+    return;
+  // touches only own particles - safe to run for all buckets in parallel
+  for(auto& emitter:impl) {
+    if(emitter.st==S_Free || emitter.block==size_t(-1))
+      continue;
+    auto& p = block[emitter.block];
+    p.hasAlive = p.count>0;
+    if(!p.hasAlive)
+      continue;
+    tick(p,emitter,dt);
+    }
+  }
+
 void PfxBucket::tick(uint64_t dt, const Vec3& viewPos) {
   if(decl.isDecal()) {
     implTickDecals(dt,viewPos);
@@ -439,19 +457,18 @@ void PfxBucket::implTickCommon(uint64_t dt, const Vec3& viewPos) {
       emitter.waitforNext-=dt;
 
     if(emitter.block!=size_t(-1)) {
+      // particles are already simulated in tickParticles
       auto& p = getBlock(emitter);
-      if(p.count>0) {
-        for(size_t i=0;i<blockSize;++i)
-          tick(p,emitter,i,dt);
-        if(p.count==0 && (emitter.st==S_Fade || !nearby)) {
-          // free mem
-          freeBlock(emitter.block);
-          if(emitter.st==S_Fade)
-            emitter.st = S_Free;
-          doShrink = true;
-          continue;
-          }
+      if(p.hasAlive && p.count==0 && (emitter.st==S_Fade || !nearby)) {
+        // free mem
+        p.hasAlive = false;
+        freeBlock(emitter.block);
+        if(emitter.st==S_Fade)
+          emitter.st = S_Free;
+        doShrink = true;
+        continue;
         }
+      p.hasAlive = false;
       }
 
     if(emitter.st==S_Active && nearby) {
@@ -482,7 +499,7 @@ void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
       } else
     if(emitter.st==S_Fade) {
       for(size_t i=0; i<blockSize; ++i)
-        particles[p.offset+i].life = 0;
+        particles.life[p.offset+i] = 0;
       p.count = 0;
       freeBlock(emitter.block);
       emitter.st = S_Free;
@@ -493,13 +510,13 @@ void PfxBucket::implTickDecals(uint64_t, const Vec3&) {
 void PfxBucket::tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited) {
   size_t lastI = 0;
   for(size_t id=1; emited>0; ++id) {
-    const size_t i  = id%blockSize;
-    ParState&    ps = particles[i+p.offset];
-    if(ps.life==0) { // free slot
+    const size_t i    = id%blockSize;
+    auto&        life = particles.life[i+p.offset];
+    if(life==0) { // free slot
       --emited;
       lastI = i;
       init(p,emitter,i+p.offset);
-      if(ps.life==0)
+      if(life==0)
         continue;
       p.count++;
       } else {
@@ -542,58 +559,12 @@ void PfxBucket::preFrameUpdate(uint8_t fId) {
 void PfxBucket::buildSsbo() {
   buildSsboTrails();
 
-  auto  colorS          = decl.visTexColorStart;
-  auto  colorE          = decl.visTexColorEnd;
-  auto  visSizeStart    = decl.visSizeStart;
-  auto  visSizeEndScale = decl.visSizeEndScale;
-  auto  visAlphaStart   = decl.visAlphaStart;
-  auto  visAlphaEnd     = decl.visAlphaEnd;
-  auto  visAlphaFunc    = decl.visMaterial.alpha;
-
+  auto vis = bilboardVisual();
   for(auto& p:block) {
     if(p.count==0)
       continue;
-
-    for(size_t pId=0; pId<blockSize; ++pId) {
-      ParState& ps = particles[pId+p.offset];
-      auto&     px = pfxCpu   [pId+p.offset];
-
-      if(ps.life==0) {
-        px.size = Vec3();
-        continue;
-        }
-
-      const float a     = ps.lifeTime();
-      const Vec3  cl    = colorS*(1.f-a)        + colorE*a;
-      const float clA   = visAlphaStart*(1.f-a) + visAlphaEnd*a;
-
-      const float scale = 1.f*(1.f-a) + a*visSizeEndScale;
-      const float szX   = visSizeStart.x*scale;
-      const float szY   = visSizeStart.y*scale;
-      const float szZ   = 0.1f*((szX+szY)*0.5f);
-
-      struct Color {
-        uint8_t r=255;
-        uint8_t g=255;
-        uint8_t b=255;
-        uint8_t a=255;
-        } color;
-
-      if(visAlphaFunc==Material::AlphaFunc::AdditiveLight) {
-        color.r = uint8_t(cl.x*clA);
-        color.g = uint8_t(cl.y*clA);
-        color.b = uint8_t(cl.z*clA);
-        color.a = uint8_t(255);
-        } else {
-        color.r = uint8_t(cl.x);
-        color.g = uint8_t(cl.y);
-        color.b = uint8_t(cl.z);
-        color.a = uint8_t(clA*255);
-        }
-      uint32_t colorU32;
-      std::memcpy(&colorU32,&color,4);
-      buildBilboard(px,p,ps, colorU32, szX,szY,szZ);
-      }
+    vis.origin = decl.useEmittersFOR ? p.pos : Vec3();
+    particles.buildBilboards(&pfxCpu[p.offset],p.offset,p.offset+blockSize,vis);
     }
   }
 
@@ -604,36 +575,38 @@ void PfxBucket::buildSsboTrails() {
   trlCpu.reserve(trlCpu.size());
   trlCpu.clear();
 
-  for(auto& p:particles) {
-    if(p.life==0)
+  for(size_t i=0; i<particles.size(); ++i) {
+    auto& trail = particles.trail[i];
+    if(particles.life[i]==0)
       continue;
-    if(p.trail.size()<2)
+    if(trail.size()<2)
       continue;
 
-    float maxT = float(std::min(maxTrlTime,p.trail[0].time));
-    for(size_t r=1; r<p.trail.size(); ++r) {
+    float maxT = float(std::min(maxTrlTime,trail[0].time));
+    for(size_t r=1; r<trail.size(); ++r) {
       PfxState st;
-      buildTrailSegment(st,p.trail[r-1],p.trail[r],maxT);
+      buildTrailSegment(st,trail[r-1],trail[r],maxT);
       trlCpu.push_back(st);
       }
     }
   }
 
-void PfxBucket::buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
-                              float szX, float szY, float szZ) {
-  if(decl.useEmittersFOR)
-    v.pos = ps.pos + p.pos; else
-    v.pos = ps.pos;
-
-  v.size  = Vec3(szX,szY,szZ);
-  v.color = color;
-  v.bits0 = 0;
+PfxParticles::Visual PfxBucket::bilboardVisual() const {
+  PfxParticles::Visual v;
+  v.colorS       = decl.visTexColorStart;
+  v.colorE       = decl.visTexColorEnd;
+  v.alphaS       = decl.visAlphaStart;
+  v.alphaE       = decl.visAlphaEnd;
+  v.sizeX        = decl.visSizeStart.x;
+  v.sizeY        = decl.visSizeStart.y;
+  v.sizeEndScale = decl.visSizeEndScale;
+  v.additive     = decl.visMaterial.alpha==Material::AlphaFunc::AdditiveLight;
   v.bits0 |= uint32_t(decl.visZBias ? 1 : 0);
   v.bits0 |= uint32_t(decl.visTexIsQuadPoly ? 1 : 0) << 1;
   v.bits0 |= uint32_t(decl.visYawAlign ? 1 : 0) << 2;
   v.bits0 |= uint32_t(0) << 3; // TODO: trails
   v.bits0 |= uint32_t(decl.visOrientation) << 4;
-  v.dir   = ps.dir;
+  return v;
   }
 
 void PfxBucket::buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT) {
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "graphics/pfx/pfxobjects.h"
+#include "graphics/pfx/pfxparticles.h"
 #include "graphics/objectsbucket.h"
 #include "resources.h"
 
@@ -39,17 +40,13 @@ class PfxBucket {
 
       uint64_t      waitforNext = 0;
       std::unique_ptr<PfxEmitter> next;
-      };
 
-    struct PfxState {
-      Tempest::Vec3 pos;
-      uint32_t      color  = 0;
-      Tempest::Vec3 size;
-      uint32_t      bits0  = 0;
-      Tempest::Vec3 dir;
-      uint32_t      colorB = 0;
+      uint64_t      seed        = 0;
+      uint64_t      rndCounter  = 0;
       };
 
+    using PfxState = PfxParticles::State;
+
     const ParticleFx&           decl;
     PfxObjects&                 parent;
 
@@ -60,6 +57,7 @@ class PfxBucket {
     void                        freeEmitter(size_t& id);
 
     ImplEmitter&                get(size_t id) { return impl[id]; }
+    void                        tickParticles(uint64_t dt);
     void                        tick(uint64_t dt, const Tempest::Vec3& viewPos);
     void                        buildSsbo();
 
@@ -70,23 +68,12 @@ class PfxBucket {
 
       size_t        offset    = 0;
       size_t        count     = 0;
+      bool          hasAlive  = false;
 
       Tempest::Vec3 pos       = {};
       };
 
-    struct Trail final {
-      Tempest::Vec3 pos;
-      uint64_t      time = 0;
-      };
-
-    struct ParState final {
-      uint16_t      life=0, maxLife=1;
-      Tempest::Vec3 pos, dir;
-
-      std::vector<Trail> trail;
-
-      float         lifeTime() const;
-      };
+    using Trail = PfxParticles::Trail;
 
     void                        tickEmit(Block& p, ImplEmitter& emitter, uint64_t emited);
     bool                        shrink();
@@ -94,23 +81,22 @@ class PfxBucket {
     size_t                      allocBlock();
     void                        freeBlock(size_t& s);
 
-    static float                randf();
-    static float                randf(float base, float var);
+    static float                randf(ImplEmitter& emitter);
+    static float                randf(ImplEmitter& emitter, float base, float var);
 
     Block&                      getBlock(ImplEmitter& emitter);
     Block&                      getBlock(PfxEmitter&  emitter);
 
     void                        init     (Block& block, ImplEmitter& emitter, size_t particle);
     void                        finalize (size_t particle);
-    void                        tick     (Block& sys, ImplEmitter& emitter, size_t particle, uint64_t dt);
-    void                        tickTrail(ParState& ps, ImplEmitter& emitter, uint64_t dt);
+    void                        tick     (Block& sys, ImplEmitter& emitter, uint64_t dt);
+    void                        tickTrail(size_t particle, ImplEmitter& emitter, uint64_t dt);
 
     void                        implTickCommon(uint64_t dt, const Tempest::Vec3& viewPos);
     void                        implTickDecals(uint64_t dt, const Tempest::Vec3& viewPos);
 
     void                        buildSsboTrails();
-    void                        buildBilboard(PfxState& v, const Block& p, const ParState& ps, const uint32_t color,
-                                              float szX, float szY, float szZ);
+    PfxParticles::Visual        bilboardVisual() const;
     void                        buildTrailSegment(PfxState& v, const Trail& a, const Trail& b, float maxT);
     uint32_t                    mkTrailColor(float clA) const;
 
@@ -127,13 +113,11 @@ class PfxBucket {
     uint64_t                    maxTrlTime = 0;
     size_t                      blockSize = 0;
 
-    std::vector<ParState>       particles;
+    PfxParticles                particles;
     std::vector<ImplEmitter>    impl;
     std::vector<Block>          block;
     bool                        forceUpdate[Resources::MaxFramesInFlight] = {};
 
-    static std::mt19937         rndEngine;
-
     friend class PfxEmitter;
   };
 
@@ -5,6 +5,7 @@
 #include <cassert>
 
 #include "graphics/sceneglobals.h"
+#include "utils/workers.h"
 
 #include "pfxbucket.h"
 #include "particlefx.h"
@@ -40,11 +41,25 @@ void PfxObjects::tick(uint64_t ticks) {
   if(dt==0)
     return;
 
+  tickList.clear();
+  for(auto& i:bucket)
+    tickList.push_back(&i);
+
+  Workers::parallelTasks(tickList,[dt](PfxBucket* b){
+    b->tickParticles(dt);
+    });
+
+  // emission may spawn nested emitters - keep it single threaded
   for(auto& i:bucket)
     i.tick(dt,viewerPos);
 
+  tickList.clear();
   for(auto& i:bucket)
-    i.buildSsbo();
+    tickList.push_back(&i);
+
+  Workers::parallelTasks(tickList,[](PfxBucket* b){
+    b->buildSsbo();
+    });
 
   lastUpdate = ticks;
   }
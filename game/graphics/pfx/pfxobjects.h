@@ -47,11 +47,14 @@ class PfxObjects final {
     std::recursive_mutex          sync;
 
     std::list<PfxBucket>          bucket;
+    std::vector<PfxBucket*>       tickList;
     std::vector<SpriteEmitter>    spriteEmit;
 
     Tempest::Vec3                 viewerPos={};
     uint64_t                      lastUpdate=0;
+    uint64_t                      emitterSeq=0;
 
   friend class PfxEmitter;
+  friend class PfxBucket;
   friend class TrlObjects;
   };
@@ -0,0 +1,121 @@
+#include "pfxparticles.h"
+
+using namespace Tempest;
+
+// streams never alias - restrict lets the loop below vectorize
+static void integrate(const uint16_t* __restrict l,
+                      float* __restrict px, float* __restrict py, float* __restrict pz,
+                      float* __restrict dx, float* __restrict dy, float* __restrict dz,
+                      const Vec3& g, float dt, size_t begin, size_t end) {
+  // branch-free body: dead particles are masked by zero time-step
+  for(size_t i=begin; i<end; ++i) {
+    const float t = l[i]!=0 ? dt : 0.f;
+    px[i] += dx[i]*t;
+    py[i] += dy[i]*t;
+    pz[i] += dz[i]*t;
+    dx[i] += g.x*t;
+    dy[i] += g.y*t;
+    dz[i] += g.z*t;
+    }
+  }
+
+// single pass over the streams; blend mode is hoisted out of the loop
+template<bool additive>
+static void buildBilboards(PfxParticles::State* __restrict out,
+                           const uint16_t* __restrict l, const uint16_t* __restrict ml,
+                           const float* __restrict px, const float* __restrict py, const float* __restrict pz,
+                           const float* __restrict dx, const float* __restrict dy, const float* __restrict dz,
+                           const PfxParticles::Visual& v, size_t count) {
+  for(size_t i=0; i<count; ++i) {
+    auto& st = out[i];
+    if(l[i]==0) {
+      st.size = Vec3();
+      continue;
+      }
+
+    const float a     = 1.f-float(l[i])/float(ml[i]);
+    const Vec3  cl    = v.colorS*(1.f-a) + v.colorE*a;
+    const float clA   = v.alphaS*(1.f-a) + v.alphaE*a;
+
+    const float scale = 1.f*(1.f-a) + a*v.sizeEndScale;
+    const float szX   = v.sizeX*scale;
+    const float szY   = v.sizeY*scale;
+    const float szZ   = 0.1f*((szX+szY)*0.5f);
+
+    uint32_t color = 0;
+    if(additive) {
+      color = uint32_t(uint8_t(cl.x*clA)) | uint32_t(uint8_t(cl.y*clA)) << 8 |
+              uint32_t(uint8_t(cl.z*clA)) << 16 | uint32_t(255) << 24;
+      } else {
+      color = uint32_t(uint8_t(cl.x)) | uint32_t(uint8_t(cl.y)) << 8 |
+              uint32_t(uint8_t(cl.z)) << 16 | uint32_t(uint8_t(clA*255)) << 24;
+      }
+
+    st.pos   = Vec3(px[i]+v.origin.x, py[i]+v.origin.y, pz[i]+v.origin.z);
+    st.color = color;
+    st.size  = Vec3(szX,szY,szZ);
+    st.bits0 = v.bits0;
+    st.dir   = Vec3(dx[i], dy[i], dz[i]);
+    }
+  }
+
+void PfxParticles::resize(size_t sz) {
+  const size_t prev = life.size();
+  life   .resize(sz);
+  maxLife.resize(sz);
+  posX   .resize(sz);
+  posY   .resize(sz);
+  posZ   .resize(sz);
+  dirX   .resize(sz);
+  dirY   .resize(sz);
+  dirZ   .resize(sz);
+  trail  .resize(sz);
+  for(size_t i=prev; i<sz; ++i)
+    reset(i);
+  }
+
+void PfxParticles::reset(size_t i) {
+  life   [i] = 0;
+  maxLife[i] = 1;
+  posX[i] = 0;
+  posY[i] = 0;
+  posZ[i] = 0;
+  dirX[i] = 0;
+  dirY[i] = 0;
+  dirZ[i] = 0;
+  trail[i].clear();
+  }
+
+void PfxParticles::setPos(size_t i, const Vec3& v) {
+  posX[i] = v.x;
+  posY[i] = v.y;
+  posZ[i] = v.z;
+  }
+
+void PfxParticles::setDir(size_t i, const Vec3& v) {
+  dirX[i] = v.x;
+  dirY[i] = v.y;
+  dirZ[i] = v.z;
+  }
+
+void PfxParticles::integrate(size_t begin, size_t end, const Vec3& gravity, float dt) {
+  ::integrate(life.data(), posX.data(), posY.data(), posZ.data(), dirX.data(), dirY.data(), dirZ.data(),
+              gravity, dt, begin, end);
+  }
+
+void PfxParticles::buildBilboards(State* out, size_t begin, size_t end, const Visual& v) const {
+  auto fn = v.additive ? ::buildBilboards<true> : ::buildBilboards<false>;
+  fn(out, life.data()+begin, maxLife.data()+begin,
+     posX.data()+begin, posY.data()+begin, posZ.data()+begin,
+     dirX.data()+begin, dirY.data()+begin, dirZ.data()+begin,
+     v, end-begin);
+  }
+
+float PfxParticles::rand(uint64_t seed, uint64_t counter) {
+  // splitmix64 finalizer
+  uint64_t z = seed + (counter+1)*0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z =  z ^ (z >> 31);
+  return float(z%10000)/10000.f;
+  }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <Tempest/Vec>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// particle state of a PfxBucket, stored as structure-of-arrays
+class PfxParticles final {
+  public:
+    struct Trail final {
+      Tempest::Vec3 pos;
+      uint64_t      time = 0;
+      };
+
+    // gpu-side particle, as read by the pfx shaders
+    struct State final {
+      Tempest::Vec3 pos;
+      uint32_t      color  = 0;
+      Tempest::Vec3 size;
+      uint32_t      bits0  = 0;
+      Tempest::Vec3 dir;
+      uint32_t      colorB = 0;
+      };
+
+    // billboard look of a bucket: life-time interpolated color, alpha and size
+    struct Visual final {
+      Tempest::Vec3 colorS, colorE;
+      float         alphaS = 1, alphaE = 1;
+      float         sizeX  = 0, sizeY  = 0, sizeEndScale = 1;
+      bool          additive = false;
+      uint32_t      bits0    = 0;
+      Tempest::Vec3 origin;
+      };
+
+    size_t        size() const { return life.size(); }
+    void          resize(size_t sz);
+    void          reset(size_t i);
+
+    Tempest::Vec3 pos(size_t i) const { return Tempest::Vec3(posX[i],posY[i],posZ[i]); }
+    Tempest::Vec3 dir(size_t i) const { return Tempest::Vec3(dirX[i],dirY[i],dirZ[i]); }
+    void          setPos(size_t i, const Tempest::Vec3& v);
+    void          setDir(size_t i, const Tempest::Vec3& v);
+    float         lifeTime(size_t i) const { return 1.f-float(life[i])/float(maxLife[i]); }
+
+    // moves alive particles in [begin,end); dead ones are left untouched
+    void          integrate(size_t begin, size_t end, const Tempest::Vec3& gravity, float dt);
+    // writes billboards of [begin,end) into out[0..end-begin); dead particles get zero size
+    void          buildBilboards(State* out, size_t begin, size_t end, const Visual& v) const;
+
+    // counter-based random stream: result depends only on (seed,counter)
+    static float  rand(uint64_t seed, uint64_t counter);
+
+    std::vector<uint16_t>           life, maxLife;
+    std::vector<float>              posX, posY, posZ;
+    std::vector<float>              dirX, dirY, dirZ;
+    std::vector<std::vector<Trail>> trail;
+  };
@@ -16,10 +16,13 @@ VisualObjects::~VisualObjects() {
 
 ObjectsBucket& VisualObjects::getBucket(ObjectsBucket::Type type, const Material& mat,
                                         const StaticMesh* st, const AnimMesh* anim, const StorageBuffer* desc) {
-  for(auto& i:buckets)
+  // candidates are kept in creation order, so assignment is same as with linear search
+  auto& candidates = bucketsByKey[ObjectsBucket::compatibilityKey(type,mat,st,anim,desc)];
+  for(auto i:candidates)
     if(i->size()<ObjectsBucket::CAPACITY && i->isCompatible(type,mat,st,anim,desc))
       return *i;
   buckets.emplace_back(ObjectsBucket::mkBucket(type,mat,*this,globals,st,anim,desc));
+  candidates.push_back(buckets.back().get());
   return *buckets.back();
   }
 
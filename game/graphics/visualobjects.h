@@ -59,6 +59,7 @@ class VisualObjects final {
     MatrixStorage                   matrix;
 
     std::vector<std::unique_ptr<ObjectsBucket>> buckets;
+    std::unordered_map<size_t,std::vector<ObjectsBucket*>> bucketsByKey;
     std::vector<ObjectsBucket*>                 index;
     size_t                                      lastSolidBucket = 0;
 
@@ -1012,6 +1012,7 @@ void MainWindow::onWorldLoaded() {
 
   if(auto c = Gothic::inst().camera()) {
     c->setViewport(uint32_t(w()),uint32_t(h()));
+    c->onWorldChanged();
     }
   renderer.onWorldChanged();
 
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+// Uniform grid over xz-plane; items are rebinned only, when they cross a cell border.
+// T provides: 'pos' (x/z), 'cell', 'cellId' and 'allId' fields, owned by the grid.
+template<class T>
+class CellGrid final {
+  public:
+    explicit CellGrid(float cellSize):cellSize(cellSize) {}
+
+    void reserve(size_t n) { all.reserve(n); }
+
+    void add(T& b) {
+      b.allId = all.size();
+      all.push_back(&b);
+      insert(b,cellKey(b.pos.x,b.pos.z));
+      }
+
+    bool del(T& b) {
+      if(b.allId>=all.size() || all[b.allId]!=&b)
+        return false;
+      erase(b);
+      all[b.allId]        = all.back();
+      all[b.allId]->allId = b.allId;
+      all.pop_back();
+      return true;
+      }
+
+    void onMove(T& b) {
+      const uint64_t key = cellKey(b.pos.x,b.pos.z);
+      if(key==b.cell)
+        return;
+      erase(b);
+      insert(b,key);
+      }
+
+    // visit items in cells, overlapping xz-rectangle [x0,x1]x[z0,z1]
+    template<class F>
+    void query(float x0, float z0, float x1, float z1, F&& fn) const {
+      const int32_t cx0 = cellCoord(x0), cx1 = cellCoord(x1);
+      const int32_t cz0 = cellCoord(z0), cz1 = cellCoord(z1);
+      if(uint64_t(cx1-cx0+1)*uint64_t(cz1-cz0+1) > all.size()) {
+        // large query area: linear scan is cheaper, than probing mostly empty cells
+        for(auto i:all)
+          fn(*i);
+        return;
+        }
+      for(int32_t x=cx0; x<=cx1; ++x)
+        for(int32_t z=cz0; z<=cz1; ++z) {
+          auto it = cells.find(cellKey(x,z));
+          if(it==cells.end())
+            continue;
+          for(auto i:it->second)
+            fn(*i);
+          }
+      }
+
+    size_t size()      const { return all.size();   }
+    size_t cellCount() const { return cells.size(); }
+
+    T* const* begin()  const { return all.data(); }
+    T* const* end()    const { return all.data()+all.size(); }
+
+  private:
+    int32_t cellCoord(float v) const {
+      return int32_t(std::floor(v/cellSize));
+      }
+
+    static uint64_t cellKey(int32_t x, int32_t z) {
+      return (uint64_t(uint32_t(x))<<32) | uint64_t(uint32_t(z));
+      }
+
+    uint64_t cellKey(float x, float z) const {
+      return cellKey(cellCoord(x),cellCoord(z));
+      }
+
+    void insert(T& b, uint64_t key) {
+      auto& c  = cells[key];
+      b.cell   = key;
+      b.cellId = c.size();
+      c.push_back(&b);
+      }
+
+    void erase(T& b) {
+      auto it = cells.find(b.cell);
+      if(it==cells.end())
+        return;
+      auto& c = it->second;
+      c[b.cellId]         = c.back();
+      c[b.cellId]->cellId = b.cellId;
+      c.pop_back();
+      if(c.empty())
+        cells.erase(it);
+      }
+
+    float                                        cellSize = 1.f;
+    std::vector<T*>                              all;
+    std::unordered_map<uint64_t,std::vector<T*>> cells;
+  };
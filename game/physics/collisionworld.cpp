@@ -3,7 +3,11 @@
 
 #include "physics/physics.h"
 #include "dynamicworld.h"
-#include "world/objects/item.h"
+#include "utils/workers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <array>
 
 CollisionWorld::CollisionBody::CollisionBody(btRigidBody::btRigidBodyConstructionInfo& inf, CollisionWorld* owner)
   :btRigidBody(inf), owner(owner) {
@@ -41,11 +45,15 @@ struct CollisionWorld::Broadphase : btDbvtBroadphase {
 
   Broadphase() {
     m_deferedcollide = true;
-    rayTestStk.reserve(btDbvt::DOUBLE_STACKSIZE);
     }
 
   void rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback,
                const btVector3& aabbMin, const btVector3& aabbMax) {
+    // per-thread stack: ray-casts are issued from Workers threads
+    static thread_local btAlignedObjectArray<const btDbvtNode*> rayTestStk;
+    if(rayTestStk.capacity()==0)
+      rayTestStk.reserve(btDbvt::DOUBLE_STACKSIZE);
+
     BroadphaseRayTester callback(rayCallback);
     btAlignedObjectArray<const btDbvtNode*>* stack = &rayTestStk;
 
@@ -71,45 +79,103 @@ struct CollisionWorld::Broadphase : btDbvtBroadphase {
         *stack,
         callback);
     }
+  };
+
+// Runs bullet parallel-for loops on Workers pool.
+// Ranges are split statically: task N always gets the same sub-range.
+struct CollisionWorld::TaskScheduler : btITaskScheduler {
+  TaskScheduler():btITaskScheduler("Workers") {}
+
+  static void install() {
+    static TaskScheduler inst;
+    // must be called from simulation thread first: bullet assigns thread-index 0 on first use
+    if(btGetTaskScheduler()!=&inst)
+      btSetTaskScheduler(&inst);
+    // per-thread solver storage and manifold pools rely on simulation thread being index 0
+    assert(btGetCurrentThreadIndex()==0);
+    }
+
+  // bullet indexes per-thread storage with global thread counter, that counts non-worker threads as well
+  int  getMaxNumThreads() const override { return BT_MAX_THREAD_COUNT; }
+  int  getNumThreads()    const override { return BT_MAX_THREAD_COUNT; }
+  void setNumThreads(int) override {}
+
+  void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override {
+    const size_t tasks = taskCount(iBegin,iEnd,grainSize);
+    if(tasks<=1) {
+      body.forLoop(iBegin,iEnd);
+      return;
+      }
+    Workers::parallelTasks(tasks,[&](uintptr_t id) {
+      nested = true;
+      body.forLoop(rangeBegin(iBegin,iEnd,tasks,id),rangeBegin(iBegin,iEnd,tasks,id+1));
+      nested = false;
+      });
+    }
 
-  btAlignedObjectArray<const btDbvtNode*> rayTestStk;
+  btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override {
+    const size_t tasks = taskCount(iBegin,iEnd,grainSize);
+    if(tasks<=1)
+      return body.sumLoop(iBegin,iEnd);
+
+    btScalar sum[MaxTasks] = {};
+    Workers::parallelTasks(tasks,[&](uintptr_t id) {
+      nested = true;
+      sum[id] = body.sumLoop(rangeBegin(iBegin,iEnd,tasks,id),rangeBegin(iBegin,iEnd,tasks,id+1));
+      nested = false;
+      });
+    // reduce in task order, to not depend on thread timings
+    btScalar ret = 0;
+    for(size_t i=0; i<tasks; ++i)
+      ret += sum[i];
+    return ret;
+    }
+
+  static size_t taskCount(int iBegin, int iEnd, int grainSize) {
+    if(nested || iEnd<=iBegin)
+      return 0; // nested loop: already on Workers thread, run inline
+    const size_t count = size_t(iEnd-iBegin);
+    const size_t grain = size_t(std::max(grainSize,1));
+    size_t limit = std::min<size_t>(Workers::maxThreads(),MaxTasks);
+    if(taskLimit>0)
+      limit = std::min(limit,taskLimit);
+    return std::min<size_t>((count+grain-1)/grain, limit);
+    }
+
+  static int rangeBegin(int iBegin, int iEnd, size_t tasks, size_t id) {
+    return iBegin + int((size_t(iEnd-iBegin)*id)/tasks);
+    }
+
+  enum { MaxTasks = 16 };
+  static thread_local bool nested;
+  static size_t            taskLimit;
   };
 
+thread_local bool CollisionWorld::TaskScheduler::nested    = false;
+size_t            CollisionWorld::TaskScheduler::taskLimit = 0;
+
 struct CollisionWorld::ContructInfo {
   ContructInfo() {
     // collision configuration contains default setup for memory, collision setup
     conf  .reset(new btDefaultCollisionConfiguration());
-    // use the default collision dispatcher. For parallel processing you can use a diffent dispatcher (see Extras/BulletMultiThreaded)
-    //auto disp = new btCollisionDispatcherMt(conf.get());
-    disp  .reset(new btCollisionDispatcher(conf.get()));
+    // narrowphase is dispatched on Workers pool, see TaskScheduler
+    disp  .reset(new btCollisionDispatcherMt(conf.get()));
     // disp->setDispatcherFlags(btCollisionDispatcher::CD_DISABLE_CONTACTPOOL_DYNAMIC_ALLOCATION); // may crash with OOM, when runout of pool
     broad .reset(new Broadphase());
-    solver.reset(new btSequentialImpulseConstraintSolver());
+    solver.reset(new btConstraintSolverPoolMt(std::max<int>(1,Workers::maxThreads())));
     }
-  std::unique_ptr<btCollisionConfiguration>            conf;
-  std::unique_ptr<btCollisionDispatcher>               disp;
-  std::unique_ptr<btSequentialImpulseConstraintSolver> solver;
-  std::unique_ptr<btBroadphaseInterface>               broad;
+  std::unique_ptr<btCollisionConfiguration>  conf;
+  std::unique_ptr<btCollisionDispatcher>     disp;
+  std::unique_ptr<btConstraintSolverPoolMt>  solver;
+  std::unique_ptr<btBroadphaseInterface>     broad;
   };
 
 CollisionWorld::CollisionWorld()
   :CollisionWorld(ContructInfo()) {
   }
 
-float CollisionWorld::toMeters(const float v) {
-  return v * 0.01f;
-  }
-
-btVector3 CollisionWorld::toMeters(const Tempest::Vec3& v) {
-  return {v.x*0.01f, v.y*0.01f, v.z*0.01f};
-  }
-
-const Tempest::Vec3 CollisionWorld::toCentimeters(const btVector3& v) {
-  return {v.x()*100.f, v.y()*100.f, v.z()*100.f};
-  }
-
 CollisionWorld::CollisionWorld(ContructInfo ci)
-  :btDiscreteDynamicsWorld(ci.disp.get(), ci.broad.get(), ci.solver.get(), ci.conf.get()) {
+  :btDiscreteDynamicsWorldMt(ci.disp.get(), ci.broad.get(), ci.solver.get(), nullptr, ci.conf.get()) {
   disp   = std::move(ci.disp);
   broad  = std::move(ci.broad);
   solver = std::move(ci.solver);
@@ -120,9 +186,13 @@ CollisionWorld::CollisionWorld(ContructInfo ci)
   setGravity(gravity);
   }
 
+void CollisionWorld::setTaskLimit(size_t n) {
+  TaskScheduler::taskLimit = n;
+  }
+
 void CollisionWorld::updateAabbs() {
   if(aabbChanged>0) {
-    btDiscreteDynamicsWorld::updateAabbs();
+    btDiscreteDynamicsWorldMt::updateAabbs();
     aabbChanged = 0;
     return;
     }
@@ -184,6 +254,99 @@ bool CollisionWorld::hasCollision(btRigidBody& it, Tempest::Vec3& normal, Intera
   return callback.count>0;
   }
 
+bool CollisionWorld::sweepTest(const btCollisionObject& it, const Tempest::Vec3& from, const Tempest::Vec3& to,
+                               float& toi, Tempest::Vec3& normal, Interactive*& vob) {
+  auto shape = it.getCollisionShape();
+  if(shape==nullptr || !shape->isConvex())
+    return false;
+  return sweepTest(*static_cast<const btConvexShape*>(shape),&it,from,to,toi,normal,vob);
+  }
+
+bool CollisionWorld::sweepTest(const btConvexShape& shape, const btCollisionObject* ignore,
+                               const Tempest::Vec3& from, const Tempest::Vec3& to,
+                               float& toi, Tempest::Vec3& normal, Interactive*& vob) {
+  struct rCallBack : public btCollisionWorld::ClosestConvexResultCallback {
+    const btCollisionObject* src = nullptr;
+
+    rCallBack(const btCollisionObject* src, const btVector3& s, const btVector3& e)
+      :ClosestConvexResultCallback(s,e), src(src) {
+      m_collisionFilterMask = btBroadphaseProxy::DefaultFilter | btBroadphaseProxy::StaticFilter;
+      }
+
+    bool needsCollision(btBroadphaseProxy* proxy0) const override {
+      auto obj=reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
+      if(obj==src)
+        return false;
+      if(obj->getUserIndex()!=DynamicWorld::C_Water &&
+         obj->getUserIndex()!=DynamicWorld::C_Ghost &&
+         obj->getUserIndex()!=DynamicWorld::C_Item)
+        return ClosestConvexResultCallback::needsCollision(proxy0);
+      return false;
+      }
+    };
+
+  btTransform s, e;
+  s.setIdentity();
+  s.setOrigin(toMeters(from));
+  e.setIdentity();
+  e.setOrigin(toMeters(to));
+  if(s.getOrigin()==e.getOrigin())
+    return false;
+
+  rCallBack callback{ignore,s.getOrigin(),e.getOrigin()};
+  updateAabbs();
+  convexSweepTest(&shape,s,e,callback);
+  if(!callback.hasHit())
+    return false;
+
+  toi    = callback.m_closestHitFraction;
+  normal = Tempest::Vec3(callback.m_hitNormalWorld.x(),callback.m_hitNormalWorld.y(),callback.m_hitNormalWorld.z());
+  vob    = nullptr;
+  if(callback.m_hitCollisionObject->getUserIndex()==DynamicWorld::C_Object)
+    vob = reinterpret_cast<Interactive*>(callback.m_hitCollisionObject->getUserPointer());
+  return true;
+  }
+
+bool CollisionWorld::overlapTest(const btConvexShape& shape, const Tempest::Vec3& at) {
+  // convex sweep doesn't report geometry, that already intersects the shape at start point
+  struct rCallBack : public btCollisionWorld::ContactResultCallback {
+    bool hit = false;
+
+    rCallBack() {
+      m_collisionFilterMask = btBroadphaseProxy::DefaultFilter | btBroadphaseProxy::StaticFilter;
+      }
+
+    bool needsCollision(btBroadphaseProxy* proxy0) const override {
+      auto obj=reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
+      if(obj->getUserIndex()!=DynamicWorld::C_Water &&
+         obj->getUserIndex()!=DynamicWorld::C_Ghost &&
+         obj->getUserIndex()!=DynamicWorld::C_Item)
+        return ContactResultCallback::needsCollision(proxy0);
+      return false;
+      }
+
+    btScalar addSingleResult(btManifoldPoint& p,
+                             const btCollisionObjectWrapper*, int, int,
+                             const btCollisionObjectWrapper*, int, int) override {
+      if(p.getDistance()<=0)
+        hit = true;
+      return 0;
+      }
+    };
+
+  btCollisionObject obj;
+  btTransform       tr;
+  tr.setIdentity();
+  tr.setOrigin(toMeters(at));
+  obj.setCollisionShape(const_cast<btConvexShape*>(&shape));
+  obj.setWorldTransform(tr);
+
+  rCallBack callback;
+  updateAabbs();
+  contactTest(&obj, callback);
+  return callback.hit;
+  }
+
 std::unique_ptr<CollisionWorld::CollisionBody> CollisionWorld::addCollisionBody(btCollisionShape& shape, const Tempest::Matrix4x4& tr, float friction) {
   btRigidBody::btRigidBodyConstructionInfo rigidBodyCI(
         0,                  // mass, in kg. 0 -> Static object, will never move.
@@ -254,8 +417,10 @@ void CollisionWorld::tick(uint64_t dt) {
   const  float dtF     = float(dt);
 
   if(dynamic) {
-    if(rigid.size()>0)
+    if(rigid.size()>0) {
+      TaskScheduler::install();
       this->stepSimulation(dtF/1000.f, 2);
+      }
 
     if(hitItem) {
       const int numManifolds = getDispatcher()->getNumManifolds();
@@ -317,20 +482,24 @@ void CollisionWorld::tick(uint64_t dt) {
       }
     }
 
-  for(auto i:rigid)
-    if(auto ptr = reinterpret_cast<::Item*>(i->getUserPointer())) {
-      auto t = i->getWorldTransform();
-      t.getOrigin()*=100.f;
-      Tempest::Matrix4x4 mt;
-      t.getOpenGLMatrix(reinterpret_cast<btScalar*>(&mt));
-      ptr->setObjMatrix(mt);
-      }
-  for(size_t i=0; i<rigid.size(); ++i) {
-    auto it = rigid[i];
-    if((it->wantsSleeping() && (it->getDeactivationTime()>3.f || !it->isActive())) ||
-       (it->getWorldTransform().getOrigin().y()<bbox[0].y()-100)) {
-      if(auto ptr = reinterpret_cast<::Item*>(it->getUserPointer()))
-        ptr->setPhysicsDisable();
+  if(moveItem) {
+    for(auto i:rigid)
+      if(auto ptr = reinterpret_cast<::Item*>(i->getUserPointer())) {
+        auto t = i->getWorldTransform();
+        t.getOrigin()*=100.f;
+        Tempest::Matrix4x4 mt;
+        t.getOpenGLMatrix(reinterpret_cast<btScalar*>(&mt));
+        moveItem(*ptr,mt);
+        }
+    }
+  if(sleepItem) {
+    for(size_t i=0; i<rigid.size(); ++i) {
+      auto it = rigid[i];
+      if((it->wantsSleeping() && (it->getDeactivationTime()>3.f || !it->isActive())) ||
+         (it->getWorldTransform().getOrigin().y()<bbox[0].y()-100)) {
+        if(auto ptr = reinterpret_cast<::Item*>(it->getUserPointer()))
+          sleepItem(*ptr);
+        }
       }
     }
   }
@@ -344,6 +513,14 @@ void CollisionWorld::setItemHitCallback(std::function<void(Item&, phoenix::mater
   hitItem = f;
   }
 
+void CollisionWorld::setItemMoveCallback(std::function<void(Item&, const Tempest::Matrix4x4&)> f) {
+  moveItem = f;
+  }
+
+void CollisionWorld::setItemSleepCallback(std::function<void(Item&)> f) {
+  sleepItem = f;
+  }
+
 bool CollisionWorld::tick(float step, btRigidBody& body) {
   Tempest::Vec3 norm;
 
@@ -367,3 +544,49 @@ void CollisionWorld::saveKinematicState(btScalar /*timeStep*/) {
   // assume no CF_KINEMATIC_OBJECT in this game
   }
 
+void CollisionWorld::performDiscreteCollisionDetection() {
+  btDiscreteDynamicsWorldMt::performDiscreteCollisionDetection();
+
+  // worker threads append new manifolds in arbitrary order - restore canonical one,
+  // so islands and solver see same contact order on every run
+  const int num = disp->getNumManifolds();
+  if(num<=1)
+    return;
+  auto uid = [](const btCollisionObject* obj) {
+    auto proxy = obj->getBroadphaseHandle();
+    return proxy==nullptr ? uint64_t(0) : uint64_t(uint32_t(proxy->m_uniqueId));
+    };
+  auto key = [&uid](const btPersistentManifold* m) {
+    uint64_t a = uid(m->getBody0());
+    uint64_t b = uid(m->getBody1());
+    return a<b ? (a<<32 | b) : (b<<32 | a);
+    };
+  // one pair may own several manifolds (compound children, mesh parts): tell them apart by shape ids of first contact
+  auto part = [&uid](const btPersistentManifold* m) {
+    if(m->getNumContacts()==0)
+      return std::array<int,4>{-1,-1,-1,-1};
+    auto& p = m->getContactPoint(0);
+    if(uid(m->getBody0())<=uid(m->getBody1()))
+      return std::array<int,4>{p.m_partId0,p.m_index0,p.m_partId1,p.m_index1};
+    return std::array<int,4>{p.m_partId1,p.m_index1,p.m_partId0,p.m_index0};
+    };
+  auto m = disp->getInternalManifoldPointer();
+  std::stable_sort(m,m+num,[&key,&part](const btPersistentManifold* a, const btPersistentManifold* b){
+    const uint64_t ka = key(a), kb = key(b);
+    if(ka!=kb)
+      return ka<kb;
+    return part(a)<part(b);
+    });
+  for(int i=0; i<num; ++i)
+    m[i]->m_index1a = i;
+  }
+
+void CollisionWorld::createPredictiveContacts(btScalar timeStep) {
+  // serial: parallel version appends manifolds under mutex, in arbitrary order
+  btDiscreteDynamicsWorld::createPredictiveContacts(timeStep);
+  }
+
+void CollisionWorld::integrateTransforms(btScalar timeStep) {
+  // serial: ccd sweeps read transforms of other bodies, while they are integrated
+  btDiscreteDynamicsWorld::integrateTransforms(timeStep);
+  }
@@ -17,30 +17,41 @@ class btConstraintSolver;
 class Item;
 class Interactive;
 
-class CollisionWorld : public btDiscreteDynamicsWorld {
+class CollisionWorld : public btDiscreteDynamicsWorldMt {
   public:
     CollisionWorld();
 
-    static float               toMeters     (const float v);
-    static btVector3           toMeters     (const Tempest::Vec3& v);
-    static const Tempest::Vec3 toCentimeters(const btVector3& v);
+    static float               toMeters     (const float v)          { return v*0.01f; }
+    static btVector3           toMeters     (const Tempest::Vec3& v) { return {v.x*0.01f, v.y*0.01f, v.z*0.01f}; }
+    static const Tempest::Vec3 toCentimeters(const btVector3& v)    { return {v.x()*100.f, v.y()*100.f, v.z()*100.f}; }
 
-    using btDiscreteDynamicsWorld::operator new;
-    using btDiscreteDynamicsWorld::operator delete;
+    using btDiscreteDynamicsWorldMt::operator new;
+    using btDiscreteDynamicsWorldMt::operator delete;
 
     class CollisionBody;
     class DynamicBody;
     class RayCallback;
 
+    // caps bullet parallel loops at 'n' tasks, 0 - one per Workers thread; simulation result doesn't depend on it
+    static void setTaskLimit(size_t n);
+
     void tick(uint64_t dt);
     void setBBox(const btVector3& min, const btVector3& max);
     void setItemHitCallback(std::function<void(Item& itm,phoenix::material_group mat,float impulse,float mass)> f);
+    void setItemMoveCallback (std::function<void(Item& itm,const Tempest::Matrix4x4& obj)> f);
+    void setItemSleepCallback(std::function<void(Item& itm)> f);
 
     void updateAabbs() override;
     void touchAabbs();
 
     bool hasCollision(const btCollisionObject &it, Tempest::Vec3& normal);
     bool hasCollision(btRigidBody& it, Tempest::Vec3& normal, Interactive*& vob);
+    bool sweepTest   (const btCollisionObject& it, const Tempest::Vec3& from, const Tempest::Vec3& to,
+                      float& toi, Tempest::Vec3& normal, Interactive*& vob);
+    bool sweepTest   (const btConvexShape& shape, const btCollisionObject* ignore,
+                      const Tempest::Vec3& from, const Tempest::Vec3& to,
+                      float& toi, Tempest::Vec3& normal, Interactive*& vob);
+    bool overlapTest (const btConvexShape& shape, const Tempest::Vec3& at);
 
     std::unique_ptr<CollisionBody> addCollisionBody(btCollisionShape& shape, const Tempest::Matrix4x4& tr, float friction);
     std::unique_ptr<DynamicBody>   addDynamicBody  (btCollisionShape& shape, const Tempest::Matrix4x4& tr, float friction, float mass);
@@ -67,6 +78,7 @@ class CollisionWorld : public btDiscreteDynamicsWorld {
   private:
     struct Broadphase;
     struct ContructInfo;
+    struct TaskScheduler;
 
     CollisionWorld(std::unique_ptr<btCollisionConfiguration>&& conf);
     CollisionWorld(ContructInfo ci);
@@ -74,13 +86,18 @@ class CollisionWorld : public btDiscreteDynamicsWorld {
     bool tick(float step, btRigidBody& body);
 
     void saveKinematicState(btScalar timeStep) override;
+    void performDiscreteCollisionDetection() override;
+    void createPredictiveContacts(btScalar timeStep) override;
+    void integrateTransforms(btScalar timeStep) override;
 
     std::unique_ptr<btCollisionConfiguration>   conf;
     std::unique_ptr<btCollisionDispatcher>      disp;
     std::unique_ptr<btBroadphaseInterface>      broad;
-    std::unique_ptr<btSequentialImpulseConstraintSolver> solver;
+    std::unique_ptr<btConstraintSolverPoolMt>   solver;
 
     std::function<void(Item& itm, phoenix::material_group mat,float impulse,float mass)>  hitItem;
+    std::function<void(Item& itm, const Tempest::Matrix4x4& obj)>                         moveItem;
+    std::function<void(Item& itm)>                                                        sleepItem;
 
     std::vector<btRigidBody*>                   rigid;
     btVector3                                   gravity = btVector3(0,0,0);
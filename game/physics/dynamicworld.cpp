@@ -3,6 +3,9 @@
 #include "collisionworld.h"
 #include "physicmeshshape.h"
 #include "physicvbo.h"
+#include "physicbvh.h"
+#include "cellgrid.h"
+#include "steplist.h"
 #include "graphics/mesh/skeleton.h"
 
 #include <algorithm>
@@ -12,10 +15,14 @@
 #include "world/objects/item.h"
 #include "world/bullet.h"
 #include "world/world.h"
+#include "utils/workers.h"
 
 const float DynamicWorld::ghostPadding=50-22.5f;
 const float DynamicWorld::ghostHeight =140;
 const float DynamicWorld::worldHeight =20000;
+const float  DynamicWorld::probeCellSize = 5.f; // 5-santimeters
+const float  DynamicWorld::probeTileSize = 400.f;
+const size_t DynamicWorld::probeCacheMax = 64*1024;
 
 struct DynamicWorld::HumShape:btCapsuleShape {
   HumShape(btScalar radius, btScalar height):btCapsuleShape(
@@ -43,15 +50,19 @@ struct DynamicWorld::NpcBody : btRigidBody {
   Tempest::Vec3 pos={};
   float         r=0, h=0, rX=0, rZ=0;
   bool          enable=true;
-  size_t        frozen=size_t(-1);
-  uint64_t      lastMove=0;
+  uint64_t      cell=0;
+  size_t        cellId=0, allId=0;
 
   Npc* toNpc() {
     return reinterpret_cast<Npc*>(getUserPointer());
     }
 
+  Tempest::Vec3 center(const Tempest::Vec3& p) const {
+    return p+Tempest::Vec3(0,(h-r-ghostPadding)*0.5f+r+ghostPadding,0);
+    }
+
   void setPosition(const Tempest::Vec3& p) {
-    auto m = CollisionWorld::toMeters(p+Tempest::Vec3(0,(h-r-ghostPadding)*0.5f+r+ghostPadding,0));
+    auto m = CollisionWorld::toMeters(center(p));
     pos = p;
     btTransform trans;
     trans.setIdentity();
@@ -61,14 +72,10 @@ struct DynamicWorld::NpcBody : btRigidBody {
   };
 
 struct DynamicWorld::NpcBodyList final {
-  struct Record final {
-    NpcBody* body = nullptr;
-    float    x    = 0.f;
-    };
+  static constexpr float cellSize = 256.f;
 
   NpcBodyList(DynamicWorld& wrld):wrld(wrld){
-    body  .reserve(1024);
-    frozen.reserve(1024);
+    grid.reserve(1024);
     }
 
   NpcBody* create(const Tempest::Vec3 &min, const Tempest::Vec3 &max) {
@@ -97,44 +104,11 @@ struct DynamicWorld::NpcBodyList final {
     }
 
   void add(NpcBody* b){
-    Record r;
-    r.body = b;
-    r.x    = b->pos.x;
-    body.push_back(r);
-    }
-
-  bool del(void* b){
-    if(del(b,body))
-      return true;
-    if(del(b,frozen)){
-      srt=false;
-      return true;
-      }
-    return false;
+    grid.add(*b);
     }
 
-  bool del(void* b,std::vector<Record>& arr){
-    for(size_t i=0;i<arr.size();++i){
-      if(arr[i].body!=b)
-        continue;
-      arr[i]=arr.back();
-      arr.pop_back();
-      return true;
-      }
-    return false;
-    }
-
-  bool delMisordered(NpcBody* b,std::vector<Record>& arr){
-    auto&       fr = arr[b->frozen];
-    const float x  = fr.x;
-    if((b->frozen==0 || arr[b->frozen-1].x<x) &&
-       (b->frozen+1==arr.size() || x<arr[b->frozen+1].x)) {
-      fr.x = fr.body->pos.x;
-      return false;
-      } else {
-      fr.body = nullptr;
-      return true;
-      }
+  bool del(NpcBody* b){
+    return grid.del(*b);
     }
 
   void resize(NpcBody& n, float h, float dx, float dz){
@@ -145,22 +119,17 @@ struct DynamicWorld::NpcBodyList final {
     n.r = std::max((dx+dz)*0.5f, dz)*0.5f;
     n.h = h;
 
-    maxR = std::max(maxR,n.r);
+    maxR   = std::max(maxR,  n.r);
+    maxRay = std::max(maxRay,0.5f*(n.rX + n.rZ));
     }
 
   void onMove(NpcBody& n){
-    if(n.frozen!=size_t(-1)) {
-      if(delMisordered(&n,frozen)){
-        n.lastMove = tick;
-        n.frozen   = size_t(-1);
-
-        Record r;
-        r.body = &n;
-        body.push_back(r);
-        }
-      } else {
-      n.lastMove = tick;
-      }
+    grid.onMove(n);
+    }
+
+  template<class F>
+  void query(float x0, float z0, float x1, float z1, F&& fn) {
+    grid.query(x0,z0,x1,z1,fn);
     }
 
   bool rayTest(NpcBody& npc, const Tempest::Vec3& s, const Tempest::Vec3& e, float extR, float& proj) {
@@ -187,68 +156,31 @@ struct DynamicWorld::NpcBodyList final {
     }
 
   NpcBody* rayTest(const Tempest::Vec3& s, const Tempest::Vec3& e, float extR) {
-    NpcBody* ret     = nullptr;
-    float    minProj = 2;
+    NpcBody*    ret     = nullptr;
+    float       minProj = 2;
+    const float R       = maxRay+extR;
 
-    for(auto i:body) {
+    query(std::min(s.x,e.x)-R, std::min(s.z,e.z)-R, std::max(s.x,e.x)+R, std::max(s.z,e.z)+R, [&](NpcBody& b) {
       float proj = 0;
-      if(rayTest(*i.body, s, e, extR, proj)) {
-        if(proj<minProj)
-          ret = i.body;
-        }
-      }
-    for(auto i:frozen) {
-      float proj = 0;
-      if(i.body!=nullptr && rayTest(*i.body, s, e, extR, proj)) {
-        if(proj<minProj)
-          ret = i.body;
+      if(rayTest(b, s, e, extR, proj)) {
+        if(proj<minProj) {
+          minProj = proj;
+          ret     = &b;
+          }
         }
-      }
+      });
     return ret;
     }
 
   bool hasCollision(const DynamicWorld::NpcItem& obj,Tempest::Vec3& normal) {
-    static bool disable=false;
-    if(disable)
-      return false;
+    const NpcBody& n  = *obj.obj;
+    const float    dX = maxR+n.r;
 
-    const NpcBody* pn = dynamic_cast<const NpcBody*>(obj.obj);
-    if(pn==nullptr)
-      return false;
-    const NpcBody& n = *pn;
-
-    if(srt){
-      if(hasCollision(n,frozen,normal,true))
-        return true;
-      return hasCollision(n,body,normal,false);
-      } else {
-      if(hasCollision(n,body,normal,false))
-        return true;
-      //adjustSort();
-      return hasCollision(n,frozen,normal,false);
-      }
-    }
-
-  bool hasCollision(const NpcBody& n,const std::vector<Record>& arr,Tempest::Vec3& normal, bool sorted) {
-    auto l = arr.begin();
-    auto r = arr.end();
-
-    if(sorted) {
-      const float dX = maxR+n.r;
-      l = std::lower_bound(arr.begin(),arr.end(),n.pos.x-dX,[](const Record& b,float x){ return b.x<x; });
-      r = std::upper_bound(arr.begin(),arr.end(),n.pos.x+dX,[](float x,const Record& b){ return x<b.x; });
-      }
-
-    const auto dist = std::distance(l,r);
-    if(dist<=1)
-      return false;
-
-    bool ret=false;
-    for(;l!=r;++l){
-      auto& v = (*l);
-      if(v.body!=nullptr && v.body->enable && hasCollision(n,*v.body,normal))
+    bool ret = false;
+    query(n.pos.x-dX, n.pos.z-dX, n.pos.x+dX, n.pos.z+dX, [&](NpcBody& b) {
+      if(b.enable && hasCollision(n,b,normal))
         ret = true;
-      }
+      });
     return ret;
     }
 
@@ -269,54 +201,79 @@ struct DynamicWorld::NpcBodyList final {
     return true;
     }
 
-  void adjustSort() {
-    srt=true;
-    std::sort(frozen.begin(),frozen.end(),[](Record& a,Record& b){
-      return a.x < b.x;
+  bool sweepTest(const NpcBody& n, const Tempest::Vec3& from, const Tempest::Vec3& to, float& toi, Tempest::Vec3& normal) {
+    const NpcBody* hit = nullptr;
+    const float    dX  = maxR+n.r;
+
+    query(std::min(from.x,to.x)-dX, std::min(from.z,to.z)-dX, std::max(from.x,to.x)+dX, std::max(from.z,to.z)+dX, [&](NpcBody& b) {
+      if(sweepTest(n,b,from,to,toi))
+        hit = &b;
       });
-    for(size_t i=0; i<frozen.size(); ++i)
-      frozen[i].body->frozen = i;
+    if(hit==nullptr)
+      return false;
+    normal = from + (to-from)*toi - hit->pos;
+    return true;
     }
 
-  void tickAabbs() {
-    for(size_t i=0;i<body.size();) {
-      if(body[i].body->lastMove!=tick){
-        auto b = body[i];
-        body[i]=body.back();
-        body.pop_back();
-
-        b.x = b.body->pos.x;
-        frozen.push_back(b);
-        } else {
-        ++i;
-        }
+  // earliest time in [0,toi), at which cylinders of 'a' moving from->to and of 'b' overlap
+  bool sweepTest(const NpcBody& a, const NpcBody& b, const Tempest::Vec3& from, const Tempest::Vec3& to, float& toi) {
+    if(&a==&b || !b.enable)
+      return false;
+    const auto  d = from - b.pos;
+    const auto  v = to   - from;
+    const float r = a.r+b.r;
+
+    float lo = 0, hi = 1;
+
+    // horizontal: |d.xz + v.xz*t| <= r
+    const float qa = v.x*v.x + v.z*v.z;
+    const float qb = 2.f*(d.x*v.x + d.z*v.z);
+    const float qc = d.x*d.x + d.z*d.z - r*r;
+    if(qa<=0.f) {
+      if(qc>0.f)
+        return false;
+      } else {
+      const float disc = qb*qb - 4.f*qa*qc;
+      if(disc<0.f)
+        return false;
+      const float sq = std::sqrt(disc);
+      lo = std::max(lo,(-qb-sq)/(2.f*qa));
+      hi = std::min(hi,(-qb+sq)/(2.f*qa));
       }
 
-    for(size_t i=0;i<frozen.size();) {
-      if(frozen[i].body==nullptr) {
-        frozen[i]=frozen.back();
-        frozen.pop_back();
-        }
-      else if(frozen[i].body->lastMove==tick){
-        frozen[i].body->frozen=size_t(-1);
-        body.push_back(frozen[i]);
-        frozen[i]=frozen.back();
-        frozen.pop_back();
-        }
-      else {
-        ++i;
-        }
+    // vertical: -a.h <= d.y + v.y*t <= b.h
+    if(v.y==0.f) {
+      if(d.y>b.h || d.y<-a.h)
+        return false;
+      } else {
+      float t0 = (-a.h-d.y)/v.y;
+      float t1 = ( b.h-d.y)/v.y;
+      if(t0>t1)
+        std::swap(t0,t1);
+      lo = std::max(lo,t0);
+      hi = std::min(hi,t1);
       }
 
-    adjustSort();
-    tick++;
+    if(lo>hi || lo>=toi)
+      return false;
+    toi = lo;
+    return true;
     }
 
-  DynamicWorld&         wrld;
-  std::vector<Record>   body, frozen;
-  bool                  srt=false;
-  uint64_t              tick=0;
-  float                 maxR=0;
+  DynamicWorld&     wrld;
+  CellGrid<NpcBody> grid{cellSize};
+  float             maxR=0;
+  float             maxRay=0;
+  };
+
+// single step of a bullet: static hits are gathered for all bullets first, callbacks run afterwards
+struct DynamicWorld::BulletStep final {
+  BulletBody*             body   = nullptr;
+  Tempest::Vec3           from   = {};
+  Tempest::Vec3           to     = {};
+  phoenix::material_group matId  = phoenix::material_group::none;
+  float                   frac   = 1.f;
+  btVector3               normal = btVector3(0,0,0);
   };
 
 struct DynamicWorld::BulletsList final {
@@ -324,26 +281,23 @@ struct DynamicWorld::BulletsList final {
     }
 
   BulletBody* add(BulletCallback* cb) {
-    BulletBody b(&wrld,cb);
-    body.push_front(std::move(b));
-    return &body.front();
+    return body.add(&wrld,cb);
     }
 
   void del(BulletBody* b) {
-    for(auto i=body.begin(), e=body.end();i!=e;++i){
-      if(&(*i)==b) {
-        body.erase(i);
-        return;
-        }
-      }
+    body.del(b);
     }
 
   void tick(uint64_t dt) {
-    for(auto& i:body) {
-      wrld.moveBullet(i,i.dir,dt);
-      if(i.cb!=nullptr)
-        i.cb->onMove();
-      }
+    // read-only ray against static world; callbacks in list order, bullets spawned by them start to move on next tick
+    body.tick([this,dt](BulletStep& s) {
+      wrld.rayBullet(s,dt);
+      },
+      [this,dt](BulletStep& s) {
+      wrld.moveBullet(s,dt);
+      if(s.body!=nullptr && s.body->cb!=nullptr)
+        s.body->cb->onMove();
+      });
     }
 
   void onMoveNpc(NpcBody& npc, NpcBodyList& list){
@@ -355,8 +309,8 @@ struct DynamicWorld::BulletsList final {
       }
     }
 
-  std::list<BulletBody> body;
-  DynamicWorld&         wrld;
+  StepList<BulletBody,BulletStep> body;
+  DynamicWorld&                   wrld;
   };
 
 struct DynamicWorld::BBoxList final {
@@ -407,23 +361,21 @@ struct DynamicWorld::BBoxList final {
   DynamicWorld&          wrld;
   };
 
-DynamicWorld::DynamicWorld(World& owner,const phoenix::mesh& worldMesh) {
-  world.reset(new CollisionWorld());
-
+DynamicWorld::Landscape::Landscape(const phoenix::mesh& worldMesh) {
   {
   PackedMesh pkg(worldMesh,PackedMesh::PK_Physic);
   sectors.resize(pkg.subMeshes.size());
   for(size_t i=0;i<sectors.size();++i)
     sectors[i] = pkg.subMeshes[i].material.name;
 
-  landVbo.resize(pkg.vertices.size());
+  vbo.resize(pkg.vertices.size());
   for(size_t i=0;i<pkg.vertices.size();++i) {
     auto v = pkg.vertices[i];
-    landVbo[i] = CollisionWorld::toMeters(Tempest::Vec3(v.pos[0],v.pos[1],v.pos[2]));
+    vbo[i] = CollisionWorld::toMeters(Tempest::Vec3(v.pos[0],v.pos[1],v.pos[2]));
     }
 
-  landMesh .reset(new PhysicVbo(&landVbo));
-  waterMesh.reset(new PhysicVbo(&landVbo));
+  landMesh .reset(new PhysicVbo(&vbo));
+  waterMesh.reset(new PhysicVbo(&vbo));
 
   for(size_t i=0;i<pkg.subMeshes.size();++i) {
     auto& sm = pkg.subMeshes[i];
@@ -437,12 +389,34 @@ DynamicWorld::DynamicWorld(World& owner,const phoenix::mesh& worldMesh) {
     }
   }
 
-  btVector3 bbox[2] = {btVector3(0,0,0), btVector3(0,0,0)};
   if(!landMesh->isEmpty()) {
+    auto shape = new btMultimaterialTriangleMeshShape(landMesh.get(),landMesh->useQuantization(),false);
+    landShape.reset(shape);
+    landBvh = PhysicBvh::attach(*shape,*landMesh,landMesh->useQuantization());
+    }
+
+  if(!waterMesh->isEmpty()) {
+    auto shape = new btMultimaterialTriangleMeshShape(waterMesh.get(),waterMesh->useQuantization(),false);
+    waterShape.reset(shape);
+    waterBvh = PhysicBvh::attach(*shape,*waterMesh,waterMesh->useQuantization());
+    }
+  }
+
+DynamicWorld::Landscape::~Landscape() {
+  }
+
+DynamicWorld::DynamicWorld(World& owner,const phoenix::mesh& worldMesh, std::unique_ptr<Landscape> landscape) {
+  world.reset(new CollisionWorld());
+
+  land = std::move(landscape);
+  if(land==nullptr)
+    land.reset(new Landscape(worldMesh));
+
+  btVector3 bbox[2] = {btVector3(0,0,0), btVector3(0,0,0)};
+  if(land->landShape!=nullptr) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    landShape.reset(new btMultimaterialTriangleMeshShape(landMesh.get(),landMesh->useQuantization(),true));
-    landBody = world->addCollisionBody(*landShape,mt,DynamicWorld::materialFriction(phoenix::material_group::none));
+    landBody = world->addCollisionBody(*land->landShape,mt,DynamicWorld::materialFriction(phoenix::material_group::none));
     landBody->setUserIndex(C_Landscape);
 
     btVector3 b[2] = {btVector3(0,0,0), btVector3(0,0,0)};
@@ -451,11 +425,10 @@ DynamicWorld::DynamicWorld(World& owner,const phoenix::mesh& worldMesh) {
     bbox[1].setMax(b[1]);
     }
 
-  if(!waterMesh->isEmpty()) {
+  if(land->waterShape!=nullptr) {
     Tempest::Matrix4x4 mt;
     mt.identity();
-    waterShape.reset(new btMultimaterialTriangleMeshShape(waterMesh.get(),waterMesh->useQuantization(),true));
-    waterBody = world->addCollisionBody(*waterShape,mt,0);
+    waterBody = world->addCollisionBody(*land->waterShape,mt,0);
     waterBody->setUserIndex(C_Water);
     waterBody->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
     // waterBody->setCollisionFlags(btCollisionObject::CO_HF_FLUID);
@@ -478,6 +451,12 @@ DynamicWorld::DynamicWorld(World& owner,const phoenix::mesh& worldMesh) {
     snd.setVolume(vol);
     snd.play();
     });
+  world->setItemMoveCallback([](::Item& itm, const Tempest::Matrix4x4& obj) {
+    itm.setObjMatrix(obj);
+    });
+  world->setItemSleepCallback([](::Item& itm) {
+    itm.setPhysicsDisable();
+    });
   }
 
 DynamicWorld::~DynamicWorld(){
@@ -495,6 +474,120 @@ DynamicWorld::RayWaterResult DynamicWorld::waterRay(const Tempest::Vec3& from) c
   return implWaterRay(from, Tempest::Vec3(from.x,from.y+worldHeight,from.z));
   }
 
+DynamicWorld::RayLandResult DynamicWorld::landRayCached(const Tempest::Vec3& from, float maxDy) {
+  auto& t  = probeTile(from);
+  auto  k  = probeKey(from,maxDy);
+  auto  it = t.land.find(k);
+  if(it!=t.land.end()) {
+    probeStats.hit++;
+    return it->second;
+    }
+  probeStats.miss++;
+  auto ret = landRay(from,maxDy);
+  t.land.emplace(k,ret);
+  if(++probeSize>probeCacheMax)
+    evictProbeCache();
+  return ret;
+  }
+
+DynamicWorld::RayWaterResult DynamicWorld::waterRayCached(const Tempest::Vec3& from) {
+  // cave test inside of waterRay depends on movers as well - same invalidation as land
+  auto& t  = probeTile(from);
+  auto  k  = probeKey(from,0);
+  auto  it = t.water.find(k);
+  if(it!=t.water.end()) {
+    probeStats.hit++;
+    return it->second;
+    }
+  probeStats.miss++;
+  auto ret = waterRay(from);
+  t.water.emplace(k,ret);
+  if(++probeSize>probeCacheMax)
+    evictProbeCache();
+  return ret;
+  }
+
+DynamicWorld::ProbeCacheStats DynamicWorld::probeCacheStats() const {
+  auto ret = probeStats;
+  ret.size = probeSize;
+  return ret;
+  }
+
+void DynamicWorld::invalidateProbeCache(const btCollisionObject& obj) {
+  if(probeTiles.empty())
+    return;
+  btVector3 min, max;
+  obj.getCollisionShape()->getAabb(obj.getWorldTransform(),min,max);
+  invalidateProbeCache(CollisionWorld::toCentimeters(min),CollisionWorld::toCentimeters(max));
+  }
+
+void DynamicWorld::invalidateProbeCache(const Tempest::Vec3& min, const Tempest::Vec3& max) {
+  const int32_t x0 = int32_t(std::floor(min.x/probeTileSize)), x1 = int32_t(std::floor(max.x/probeTileSize));
+  const int32_t z0 = int32_t(std::floor(min.z/probeTileSize)), z1 = int32_t(std::floor(max.z/probeTileSize));
+
+  auto drop = [this](std::unordered_map<uint64_t,ProbeTile>::iterator it) {
+    probeSize -= it->second.land.size() + it->second.water.size();
+    return probeTiles.erase(it);
+    };
+
+  const uint64_t area = uint64_t(int64_t(x1)-x0+1)*uint64_t(int64_t(z1)-z0+1);
+  if(area>probeTiles.size()) {
+    // huge body: cheaper to test every cached tile
+    for(auto it=probeTiles.begin(); it!=probeTiles.end();) {
+      const int32_t x = int32_t(it->first >> 32), z = int32_t(uint32_t(it->first));
+      if(x0<=x && x<=x1 && z0<=z && z<=z1)
+        it = drop(it); else
+        ++it;
+      }
+    return;
+    }
+
+  for(int32_t x=x0; x<=x1; ++x)
+    for(int32_t z=z0; z<=z1; ++z) {
+      auto it = probeTiles.find(probeTileKey(x,z));
+      if(it!=probeTiles.end())
+        drop(it);
+      }
+  }
+
+void DynamicWorld::evictProbeCache() {
+  // drop least recently used tiles, until half of budget is free
+  std::vector<std::pair<uint64_t,uint64_t>> age;
+  age.reserve(probeTiles.size());
+  for(auto& i:probeTiles)
+    age.emplace_back(i.second.lastUse,i.first);
+  std::sort(age.begin(),age.end());
+
+  for(auto& i:age) {
+    if(probeSize<=probeCacheMax/2)
+      break;
+    auto it = probeTiles.find(i.second);
+    probeSize -= it->second.land.size() + it->second.water.size();
+    probeTiles.erase(it);
+    }
+  }
+
+uint64_t DynamicWorld::probeTileKey(int32_t x, int32_t z) {
+  return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(z));
+  }
+
+DynamicWorld::ProbeTile& DynamicWorld::probeTile(const Tempest::Vec3& p) {
+  const int32_t x = int32_t(std::floor(p.x/probeTileSize));
+  const int32_t z = int32_t(std::floor(p.z/probeTileSize));
+  auto& t = probeTiles[probeTileKey(x,z)];
+  t.lastUse = ++probeClock;
+  return t;
+  }
+
+DynamicWorld::ProbeKey DynamicWorld::probeKey(const Tempest::Vec3& p, float dy) {
+  ProbeKey k;
+  k.x  = int32_t(std::floor(p.x/probeCellSize));
+  k.y  = int32_t(std::floor(p.y/probeCellSize));
+  k.z  = int32_t(std::floor(p.z/probeCellSize));
+  k.dy = dy;
+  return k;
+  }
+
 DynamicWorld::RayWaterResult DynamicWorld::waterRay(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
   world->updateAabbs();
   return implWaterRay(from, to);
@@ -597,6 +690,27 @@ DynamicWorld::RayLandResult DynamicWorld::ray(const Tempest::Vec3& from, const T
   return ret;
   }
 
+DynamicWorld::RayLandResult DynamicWorld::sweepSphere(const Tempest::Vec3& from, const Tempest::Vec3& to, float R) const {
+  btSphereShape sphere(CollisionWorld::toMeters(R));
+  float         toi = 1.f;
+  Tempest::Vec3 norm;
+  Interactive*  vob = nullptr;
+
+  RayLandResult ret;
+  if(world->overlapTest(sphere,from)) {
+    // starts inside of geometry
+    ret.hasCol      = true;
+    ret.hitFraction = 0;
+    ret.v           = from;
+    return ret;
+    }
+  ret.hasCol      = world->sweepTest(sphere,nullptr,from,to,toi,norm,vob);
+  ret.hitFraction = ret.hasCol ? toi : 1.f;
+  ret.v           = from + (to-from)*ret.hitFraction;
+  ret.n           = norm;
+  return ret;
+  }
+
 DynamicWorld::RayQueryResult DynamicWorld::rayNpc(const Tempest::Vec3& from, const Tempest::Vec3& to) const {
   RayQueryResult r;
   static_cast<RayLandResult&>(r) = ray(from,to);
@@ -682,6 +796,7 @@ DynamicWorld::Item DynamicWorld::createObj(btCollisionShape* shape, bool ownShap
     case IT_Static:
       obj = world->addCollisionBody(*shape,m,friction);
       obj->setUserIndex(C_Object);
+      invalidateProbeCache(*obj);
       break;
     case IT_Dynamic:
       obj = world->addDynamicBody(*shape,m,friction,mass);
@@ -717,12 +832,12 @@ DynamicWorld::BBoxBody DynamicWorld::bboxObj(BBoxCallback* cb, const Tempest::Ve
   return BBoxBody(this,cb,pos,R);
   }
 
-void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t dt) {
-  const float dtF     = float(dt);
-  const bool  isSpell = b.isSpell();
+void DynamicWorld::rayBullet(BulletStep& s, uint64_t dt) {
+  auto&       b   = *s.body;
+  const float dtF = float(dt);
 
-  auto  pos = b.pos;
-  auto  to  = pos + dir*dtF - Tempest::Vec3(0,(isSpell ? 0 : gravity*dtF*dtF),0);
+  s.from = b.pos;
+  s.to   = s.from + b.dir*dtF - Tempest::Vec3(0,(b.isSpell() ? 0 : gravity*dtF*dtF),0);
 
   struct CallBack:btCollisionWorld::ClosestRayResultCallback {
     using ClosestRayResultCallback::ClosestRayResultCallback;
@@ -748,29 +863,44 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
       }
     };
 
-  btVector3 s=CollisionWorld::toMeters(pos), e=CollisionWorld::toMeters(to);
+  btVector3 rs=CollisionWorld::toMeters(s.from), re=CollisionWorld::toMeters(s.to);
 
-  CallBack callback{s,e};
+  CallBack callback{rs,re};
   callback.m_flags = btTriangleRaycastCallback::kF_KeepUnflippedNormal | btTriangleRaycastCallback::kF_FilterBackfaces;
 
-  if(auto ptr = bboxList->rayTest(s,e)) {
-    if(ptr->cb!=nullptr) {
-      ptr->cb->onCollide(b);
-      }
+  world->rayCast(s.from, s.to, callback);
+
+  s.matId = callback.matId;
+  if(s.matId != phoenix::material_group::none) {
+    s.frac   = callback.m_closestHitFraction;
+    s.normal = callback.m_hitNormalWorld;
     }
+  }
+
+void DynamicWorld::moveBullet(const BulletStep& s, uint64_t dt) {
+  auto&       b       = *s.body;
+  const float dtF     = float(dt);
+  const bool  isSpell = b.isSpell();
 
-  world->rayCast(pos, to, callback);
+  auto  pos = s.from;
+  auto  to  = s.to;
 
-  if(callback.matId != phoenix::material_group::none) {
+  // triggers and npcs are queried here, not in parallel pass: callbacks of previous bullets may remove them
+  if(auto bbox = bboxList->rayTest(CollisionWorld::toMeters(pos),CollisionWorld::toMeters(to))) {
+    if(bbox->cb!=nullptr)
+      bbox->cb->onCollide(b);
+    }
+
+  if(s.matId != phoenix::material_group::none) {
     if(isSpell){
       if(b.cb!=nullptr)
-        b.cb->onCollide(callback.matId);
+        b.cb->onCollide(s.matId);
       } else {
-      if(callback.matId==phoenix::material_group::metal ||
-         callback.matId==phoenix::material_group::stone) {
+      if(s.matId==phoenix::material_group::metal ||
+         s.matId==phoenix::material_group::stone) {
         auto d = b.dir;
         btVector3 m = {d.x,d.y,d.z};
-        btVector3 n = callback.m_hitNormalWorld;
+        btVector3 n = s.normal;
 
         n.normalize();
         const float l = b.speed();
@@ -779,27 +909,27 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
         btVector3 dir = m - 2*m.dot(n)*n;
         dir*=(l*0.5f); //slow-down
 
-        float a = callback.m_closestHitFraction;
+        float a = s.frac;
         b.move(pos + (to-pos)*a);
         if(l*a>0.1f) {
           b.setDirection({dir.x(),dir.y(),dir.z()});
           b.addPathLen(l*a);
           b.addHit();
           if(b.cb!=nullptr)
-            b.cb->onCollide(callback.matId);
+            b.cb->onCollide(s.matId);
           }
         } else {
-        float a = callback.m_closestHitFraction;
+        float a = s.frac;
         b.move(pos + (to-pos)*a);
         if(b.cb!=nullptr)
-          b.cb->onCollide(callback.matId);
+          b.cb->onCollide(s.matId);
         }
       }
     b.addHit();
     } else {
-    if(auto ptr = npcList->rayTest(pos,to,b.targetRange())) {
+    if(auto npc = npcList->rayTest(pos,to,b.targetRange())) {
       if(b.cb!=nullptr)
-        b.cb->onCollide(*ptr->toNpc());
+        b.cb->onCollide(*npc->toNpc());
       }
     const float l = b.speed();
     auto        d = b.direction();
@@ -814,7 +944,6 @@ void DynamicWorld::moveBullet(BulletBody &b, const Tempest::Vec3& dir, uint64_t
   }
 
 void DynamicWorld::tick(uint64_t dt) {
-  npcList   ->tickAabbs();
   bulletList->tick(dt);
   world     ->tick(dt);
   }
@@ -868,7 +997,7 @@ float DynamicWorld::materialDensity(phoenix::material_group mat) {
 }
 
 std::string_view DynamicWorld::validateSectorName(std::string_view name) const {
-  return landMesh->validateSectorName(name);
+  return land->landMesh->validateSectorName(name);
   }
 
 bool DynamicWorld::hasCollision(const NpcItem& it, CollisionTest& out) {
@@ -880,6 +1009,31 @@ bool DynamicWorld::hasCollision(const NpcItem& it, CollisionTest& out) {
   return world->hasCollision(*it.obj,out.normal,out.vob);
   }
 
+bool DynamicWorld::sweepTest(const NpcItem& it, const Tempest::Vec3& from, const Tempest::Vec3& to, CollisionTest& out) {
+  float         toiN = 1.f, toiW = 1.f;
+  Tempest::Vec3 normN, normW;
+  Interactive*  vob  = nullptr;
+
+  const bool hitN = npcList->sweepTest(*it.obj,from,to,toiN,normN);
+  const bool hitW = world->sweepTest(*it.obj,it.obj->center(from),it.obj->center(to),toiW,normW,vob);
+
+  if(hitN && (!hitW || toiN<=toiW)) {
+    out.toi    = toiN;
+    out.normal = normN;
+    if(normN.length()>0.f)
+      out.normal /= normN.length();
+    out.npcCol = true;
+    return true;
+    }
+  if(hitW) {
+    out.toi    = toiW;
+    out.normal = normW;
+    out.vob    = vob;
+    return true;
+    }
+  return false;
+  }
+
 DynamicWorld::NpcItem::~NpcItem() {
   if(owner==nullptr)
     return;
@@ -980,27 +1134,26 @@ DynamicWorld::MoveCode DynamicWorld::NpcItem::implTryMove(const Tempest::Vec3& t
     count = std::max(countXZ,countY);
     }
 
-  auto prev = initial;
-  for(int i=1; i<=count; ++i) {
-    auto pos = initial+(dp*float(i))/float(count);
-    implSetPosition(pos);
-    if(owner->hasCollision(*this,out)) {
-      if(i>1) {
-        // moved a bit
-        out.partial = prev;
-        return MoveCode::MC_Partial;
-        }
-      implSetPosition(initial);
-      if(owner->hasCollision(*this,out)) {
-        // was in collision from the start
-        implSetPosition(to);
-        return MoveCode::MC_OK;
-        }
-      return MoveCode::MC_Fail;
-      }
+  if(!owner->sweepTest(*this,initial,to,out)) {
+    implSetPosition(to);
+    return MoveCode::MC_OK;
+    }
+
+  // classify hit the same way, as fixed-size stepping would do
+  const int step = std::max(1,int(std::ceil(out.toi*float(count))));
+  if(step>1) {
+    // moved a bit
+    out.partial = initial;
+    return MoveCode::MC_Partial;
     }
 
-  return MoveCode::MC_OK;
+  implSetPosition(initial);
+  if(owner->hasCollision(*this,out)) {
+    // was in collision from the start
+    implSetPosition(to);
+    return MoveCode::MC_OK;
+    }
+  return MoveCode::MC_Fail;
   }
 
 bool DynamicWorld::NpcItem::hasCollision() const {
@@ -1011,6 +1164,8 @@ bool DynamicWorld::NpcItem::hasCollision() const {
   }
 
 DynamicWorld::Item::~Item() {
+  if(obj!=nullptr && obj->getUserIndex()==C_Object)
+    owner->invalidateProbeCache(*obj);
   delete obj;
   delete shp;
   }
@@ -1022,9 +1177,14 @@ void DynamicWorld::Item::setObjMatrix(const Tempest::Matrix4x4 &m) {
     trans.getOrigin()*=0.01f;
     if(obj->getWorldTransform()==trans)
       return;
+    // probes under old and new placement
+    if(obj->getUserIndex()==C_Object)
+      owner->invalidateProbeCache(*obj);
     obj->setWorldTransform(trans);
     //owner->world->touchAabbs(); // TOO SLOW!
     owner->world->updateSingleAabb(obj);
+    if(obj->getUserIndex()==C_Object)
+      owner->invalidateProbeCache(*obj);
     }
   }
 
@@ -3,6 +3,7 @@
 #include <phoenix/mesh.hh>
 
 #include <Tempest/Matrix4x4>
+#include <unordered_map>
 #include <memory>
 #include <limits>
 
@@ -14,6 +15,7 @@ class btVector3;
 
 class PhysicMeshShape;
 class PhysicVbo;
+class PhysicBvh;
 class PackedMesh;
 class Bounds;
 
@@ -31,6 +33,7 @@ class DynamicWorld final {
     struct NpcBody;
     struct NpcBodyList;
     struct BulletsList;
+    struct BulletStep;
     struct BBoxList;
 
   public:
@@ -40,7 +43,23 @@ class DynamicWorld final {
     static constexpr float spellSpeed  = 1; // centimeters per milliseconds
     static const     float ghostPadding;
 
-    DynamicWorld(World &world, const phoenix::mesh& mesh);
+    // static collision geometry of a world; doesn't need a world instance, so can be built ahead of time
+    struct Landscape final {
+      Landscape(const phoenix::mesh& mesh);
+      Landscape(const Landscape&)=delete;
+      ~Landscape();
+
+      std::vector<std::string>          sectors;
+      std::vector<btVector3>            vbo;
+      std::unique_ptr<PhysicVbo>        landMesh;
+      std::unique_ptr<PhysicBvh>        landBvh;
+      std::unique_ptr<btCollisionShape> landShape;
+      std::unique_ptr<PhysicVbo>        waterMesh;
+      std::unique_ptr<PhysicBvh>        waterBvh;
+      std::unique_ptr<btCollisionShape> waterShape;
+      };
+
+    DynamicWorld(World &world, const phoenix::mesh& mesh, std::unique_ptr<Landscape> landscape = nullptr);
     DynamicWorld(const DynamicWorld&)=delete;
     ~DynamicWorld();
 
@@ -66,6 +85,7 @@ class DynamicWorld final {
       bool          npcCol  = false;
       bool          preFall = false;
       Interactive*  vob     = nullptr;
+      float         toi     = 1.f;
       };
 
     struct NpcItem {
@@ -149,6 +169,12 @@ class DynamicWorld final {
       Npc* npcHit = nullptr;
       };
 
+    struct ProbeCacheStats {
+      uint64_t hit  = 0;
+      uint64_t miss = 0;
+      size_t   size = 0;
+      };
+
     struct BulletCallback {
       virtual ~BulletCallback()=default;
       virtual void onStop(){}
@@ -227,9 +253,13 @@ class DynamicWorld final {
 
     RayLandResult  landRay      (const Tempest::Vec3& from, float maxDy=0) const;
     RayWaterResult waterRay     (const Tempest::Vec3& from) const;
+    RayLandResult  landRayCached (const Tempest::Vec3& from, float maxDy=0);
+    RayWaterResult waterRayCached(const Tempest::Vec3& from);
+    auto           probeCacheStats() const -> ProbeCacheStats;
     RayWaterResult waterRay     (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
 
     RayLandResult  ray          (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
+    RayLandResult  sweepSphere  (const Tempest::Vec3& from, const Tempest::Vec3& to, float R) const;
     RayQueryResult rayNpc       (const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     float          soundOclusion(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
 
@@ -261,27 +291,58 @@ class DynamicWorld final {
                              float mass, float friction, ItemType type);
 
 
-    void           moveBullet(BulletBody& b, const Tempest::Vec3& dir, uint64_t dt);
+    void           rayBullet (BulletStep& s, uint64_t dt);
+    void           moveBullet(const BulletStep& s, uint64_t dt);
     RayWaterResult implWaterRay(const Tempest::Vec3& from, const Tempest::Vec3& to) const;
     bool           hasCollision(const NpcItem &it, CollisionTest& out);
+    bool           sweepTest   (const NpcItem &it, const Tempest::Vec3& from, const Tempest::Vec3& to, CollisionTest& out);
+    void           invalidateProbeCache(const btCollisionObject& obj);
+    void           invalidateProbeCache(const Tempest::Vec3& min, const Tempest::Vec3& max);
+    void           evictProbeCache();
+
+    struct ProbeKey {
+      int32_t x=0, y=0, z=0;
+      float   dy=0;
+      bool operator == (const ProbeKey& other) const {
+        return x==other.x && y==other.y && z==other.z && dy==other.dy;
+        }
+      };
 
-    std::unique_ptr<CollisionWorld>    world;
+    struct ProbeHash {
+      size_t operator()(const ProbeKey& k) const {
+        return size_t(uint32_t(k.x)*73856093u ^ uint32_t(k.y)*19349663u ^ uint32_t(k.z)*83492791u);
+        }
+      };
 
-    std::vector<std::string>           sectors;
+    // probes are vertical rays: cached per xz-tile, so a moved body drops only tiles under it
+    struct ProbeTile {
+      std::unordered_map<ProbeKey,RayLandResult, ProbeHash> land;
+      std::unordered_map<ProbeKey,RayWaterResult,ProbeHash> water;
+      uint64_t                                               lastUse = 0;
+      };
 
-    std::vector<btVector3>             landVbo;
-    std::unique_ptr<PhysicVbo>         landMesh;
-    std::unique_ptr<btCollisionShape>  landShape;
-    std::unique_ptr<btRigidBody>       landBody;
+    static ProbeKey    probeKey(const Tempest::Vec3& p, float dy);
+    static uint64_t    probeTileKey(int32_t x, int32_t z);
+    ProbeTile&         probeTile(const Tempest::Vec3& p);
+
+    std::unique_ptr<CollisionWorld>    world;
 
-    std::unique_ptr<btCollisionShape>  waterShape;
+    std::unique_ptr<Landscape>         land;
+    std::unique_ptr<btRigidBody>       landBody;
     std::unique_ptr<btRigidBody>       waterBody;
-    std::unique_ptr<PhysicVbo>         waterMesh;
 
     std::unique_ptr<NpcBodyList>       npcList;
     std::unique_ptr<BulletsList>       bulletList;
     std::unique_ptr<BBoxList>          bboxList;
 
+    std::unordered_map<uint64_t,ProbeTile> probeTiles;
+    size_t                             probeSize  = 0;
+    uint64_t                           probeClock = 0;
+    ProbeCacheStats                    probeStats;
+
     static const float                 ghostHeight;
     static const float                 worldHeight;
+    static const float                 probeCellSize;
+    static const float                 probeTileSize;
+    static const size_t                probeCacheMax;
   };
@@ -0,0 +1,91 @@
+#include "physicbvh.h"
+
+#include <limits>
+#include <mutex>
+
+#include "utils/diskcache.h"
+#include "physicvbo.h"
+
+static std::mutex                       cacheSync;
+static std::shared_ptr<const DiskCache> cache;
+
+PhysicBvh::PhysicBvh(void* data, btOptimizedBvh* bvh)
+  :data(data), bvh(bvh) {
+  }
+
+PhysicBvh::~PhysicBvh() {
+  // deserialized in-place: arrays point into 'data' and own no memory
+  bvh->~btOptimizedBvh();
+  btAlignedFree(data);
+  }
+
+void PhysicBvh::setCacheDir(std::u16string dir) {
+  auto d = std::make_shared<const DiskCache>(std::move(dir),"bvh cache",u".bvh","OGBV",uint32_t(Version));
+  std::lock_guard<std::mutex> guard(cacheSync);
+  cache = d->isOpen() ? d : nullptr;
+  }
+
+std::unique_ptr<PhysicBvh> PhysicBvh::attach(btBvhTriangleMeshShape& shape, const PhysicVbo& mesh, bool quantized) {
+  std::shared_ptr<const DiskCache> disk;
+  {
+  std::lock_guard<std::mutex> guard(cacheSync);
+  disk = cache;
+  }
+
+  if(disk==nullptr || mesh.triangleCount()<MinTriangles) {
+    // small meshes are cheaper to build, than to look up
+    shape.buildOptimizedBvh();
+    return nullptr;
+    }
+
+  const uint64_t key = mesh.contentHash(quantized);
+  if(auto ret = load(*disk,key,quantized)) {
+    shape.setOptimizedBvh(ret->bvh);
+    return ret;
+    }
+
+  shape.buildOptimizedBvh();
+  if(auto bvh = shape.getOptimizedBvh())
+    store(*disk,key,*bvh);
+  return nullptr;
+  }
+
+std::unique_ptr<PhysicBvh> PhysicBvh::load(const DiskCache& disk, uint64_t key, bool quantized) {
+  Meta   meta;
+  void*  data = nullptr;
+  size_t size = 0;
+  bool   ok   = disk.load(key,&meta,sizeof(meta),[&](size_t dataSize) -> void* {
+    if(meta.bullet!=BT_BULLET_VERSION || meta.scalar!=sizeof(btScalar))
+      return nullptr;
+    if(dataSize==0 || dataSize>std::numeric_limits<unsigned>::max())
+      return nullptr;
+    size = dataSize;
+    data = btAlignedAlloc(size,16);
+    return data;
+    });
+  if(!ok) {
+    btAlignedFree(data);
+    return nullptr;
+    }
+
+  // NOTE: in-place deserialization patches pointers inside of buffer, so file can't be mapped read-only
+  auto bvh = btOptimizedBvh::deSerializeInPlace(data,unsigned(size),false);
+  if(bvh==nullptr) {
+    btAlignedFree(data);
+    return nullptr;
+    }
+  std::unique_ptr<PhysicBvh> ret(new PhysicBvh(data,bvh));
+  if(bvh->isQuantized()!=quantized)
+    return nullptr;
+  return ret;
+  }
+
+void PhysicBvh::store(const DiskCache& disk, uint64_t key, const btOptimizedBvh& bvh) {
+  const unsigned size = bvh.calculateSerializeBufferSize();
+  void*          data = btAlignedAlloc(size,16);
+  if(bvh.serializeInPlace(data,size,false)) {
+    Meta meta;
+    disk.store(key,&meta,sizeof(meta),data,size);
+    }
+  btAlignedFree(data);
+  }
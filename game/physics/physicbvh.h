@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "physics/physics.h"
+
+class PhysicVbo;
+class DiskCache;
+
+// Optimized bvh of a static triangle mesh, restored from on-disk cache.
+// Must outlive the shape it is attached to.
+class PhysicBvh final {
+  public:
+    PhysicBvh(const PhysicBvh&)=delete;
+    ~PhysicBvh();
+
+    static void setCacheDir(std::u16string dir);
+
+    // builds or restores bvh of 'shape'; returns storage of a restored bvh, if any
+    static std::unique_ptr<PhysicBvh> attach(btBvhTriangleMeshShape& shape, const PhysicVbo& mesh, bool quantized);
+
+  private:
+    PhysicBvh(void* data, btOptimizedBvh* bvh);
+
+    enum {
+      Version      = 2,
+      MinTriangles = 2048,
+      };
+
+    struct Meta {
+      uint32_t bullet = BT_BULLET_VERSION;
+      uint32_t scalar = sizeof(btScalar);
+      };
+
+    static std::unique_ptr<PhysicBvh> load (const DiskCache& disk, uint64_t key, bool quantized);
+    static void                       store(const DiskCache& disk, uint64_t key, const btOptimizedBvh& bvh);
+
+    void*           data = nullptr;
+    btOptimizedBvh* bvh  = nullptr;
+  };
@@ -19,7 +19,8 @@ PhysicMeshShape* PhysicMeshShape::load(PackedMesh&& packed) {
 }
 
 PhysicMeshShape::PhysicMeshShape(PackedMesh&& sPacked)
-  :mesh(std::move(sPacked)), shape(&mesh,true,true) {
+  :mesh(std::move(sPacked)), shape(&mesh,true,false) {
+  bvh = PhysicBvh::attach(shape,mesh,true);
   for(auto& i:sPacked.subMeshes)
     frict += DynamicWorld::materialFriction(i.material.group);
   frict = frict/float(sPacked.subMeshes.size());
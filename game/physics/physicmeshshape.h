@@ -2,6 +2,7 @@
 
 #include "physics/physics.h"
 #include "physicvbo.h"
+#include "physicbvh.h"
 
 class PhysicMeshShape final {
   public:
@@ -15,6 +16,7 @@ class PhysicMeshShape final {
     PhysicMeshShape(PackedMesh&& packed);
 
     PhysicVbo                      mesh;
+    std::unique_ptr<PhysicBvh>     bvh;
     mutable btBvhTriangleMeshShape shape;
     float                          frict = 0;
 
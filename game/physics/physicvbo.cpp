@@ -1,6 +1,9 @@
 #include "physicvbo.h"
 
+#include <cstring>
+
 #include "graphics/mesh/submesh/packedmesh.h"
+#include "utils/fnvhash.h"
 #include "collisionworld.h"
 
 PhysicVbo::PhysicVbo(PackedMesh&& packed)
@@ -98,6 +101,36 @@ bool PhysicVbo::isEmpty() const {
   return segments.size()==0;
   }
 
+size_t PhysicVbo::triangleCount() const {
+  size_t ret = 0;
+  for(auto& i:segments)
+    ret += size_t(i.size);
+  return ret;
+  }
+
+uint64_t PhysicVbo::contentHash(bool quantized) const {
+  uint64_t h = FnvHash::basis;
+  auto mix = [&h](uint64_t v) {
+    h = FnvHash::mix(h,v);
+    };
+
+  mix(quantized ? 1 : 0);
+  mix(vert.size());
+  for(auto& v:vert) {
+    uint32_t xyz[3] = {};
+    float    f  [3] = {float(v.x()), float(v.y()), float(v.z())};
+    std::memcpy(xyz,f,sizeof(xyz));
+    mix(uint64_t(xyz[0]) | (uint64_t(xyz[1])<<32));
+    mix(xyz[2]);
+    }
+  for(auto& s:segments) {
+    mix(uint64_t(s.size));
+    for(size_t i=0; i<size_t(s.size)*3; ++i)
+      mix(id[s.off+i]);
+    }
+  return h;
+  }
+
 void PhysicVbo::adjustMesh(){
   for(int i=0;i<m_indexedMeshes.size();++i) {
     btIndexedMesh& meshIndex=m_indexedMeshes[i];
@@ -25,6 +25,8 @@ class PhysicVbo : public btTriangleIndexVertexArray {
     auto                    sectorName(size_t segment) const -> const char*;
     bool                    useQuantization() const;
     bool                    isEmpty() const;
+    size_t                  triangleCount() const;
+    uint64_t                contentHash(bool quantized) const;
 
     void                    adjustMesh();
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <list>
+#include <vector>
+
+#include "utils/workers.h"
+
+// Objects, stepped in two phases: 'query' runs in parallel over all objects, 'apply' runs serially in list order.
+// Apply may add or delete objects: deleted ones are skipped, added ones are stepped on next tick.
+// Step provides 'body' (T*), owned by the list; query results must not point to objects, that apply may destroy.
+template<class T, class Step>
+class StepList final {
+  public:
+    template<class... Args>
+    T* add(Args&&... args) {
+      body.emplace_front(std::forward<Args>(args)...);
+      return &body.front();
+      }
+
+    bool del(T* b) {
+      for(auto i=body.begin(), e=body.end(); i!=e; ++i) {
+        if(&(*i)!=b)
+          continue;
+        // deleted from within apply phase
+        for(auto& s:steps)
+          if(s.body==b)
+            s.body = nullptr;
+        body.erase(i);
+        return true;
+        }
+      return false;
+      }
+
+    template<class Query, class Apply>
+    void tick(const Query& query, const Apply& apply) {
+      steps.clear();
+      for(auto& i:body) {
+        Step s;
+        s.body = &i;
+        steps.push_back(s);
+        }
+
+      Workers::parallelFor(steps,[&query](Step& s) {
+        query(s);
+        });
+
+      // 'steps' doesn't grow during apply: new objects are not in it
+      for(auto& s:steps) {
+        if(s.body!=nullptr)
+          apply(s);
+        }
+      }
+
+    size_t size() const { return body.size(); }
+
+    auto begin() { return body.begin(); }
+    auto end()   { return body.end();   }
+
+  private:
+    std::list<T>      body;
+    std::vector<Step> steps;
+  };
@@ -20,6 +20,8 @@
 #include <phoenix/ext/dds_convert.hh>
 
 #include <fstream>
+#include <cassert>
+#include <unordered_set>
 
 #include "graphics/mesh/submesh/pfxemittermesh.h"
 #include "graphics/mesh/submesh/packedmesh.h"
@@ -29,15 +31,21 @@
 #include "graphics/mesh/attachbinder.h"
 #include "graphics/material.h"
 #include "dmusic/directmusic.h"
+#include "dmusic/samplebank.h"
+#include "physics/physicbvh.h"
 #include "utils/fileext.h"
+#include "utils/fileutil.h"
 #include "utils/gthfont.h"
+#include "utils/texturediskcache.h"
 
 #include "gothic.h"
+#include "commandline.h"
 #include "utils/string_frm.h"
 
 using namespace Tempest;
 
-Resources* Resources::inst=nullptr;
+Resources*            Resources::inst=nullptr;
+std::atomic<uint64_t> Resources::useTick{0};
 
 static void emplaceTag(char* buf, char tag){
   for(size_t i=1;buf[i];++i){
@@ -50,6 +58,24 @@ static void emplaceTag(char* buf, char tag){
     }
   }
 
+static bool isDxtTexture(const phoenix::buffer& data) {
+  // ZTEX header: signature, version, format
+  uint32_t frm = 0;
+  if(data.limit()<12)
+    return false;
+  std::memcpy(&frm,data.array()+8,sizeof(frm));
+  switch(phoenix::texture_format(frm)) {
+    case phoenix::tex_dxt1:
+    case phoenix::tex_dxt2:
+    case phoenix::tex_dxt3:
+    case phoenix::tex_dxt4:
+    case phoenix::tex_dxt5:
+      return true;
+    default:
+      return false;
+    }
+  }
+
 Resources::Resources(Tempest::Device &device)
   : dev(device) {
   inst=this;
@@ -63,6 +89,10 @@ Resources::Resources(Tempest::Device &device)
 
   //sp = sphere(3,1.f);
 
+  if(CommandLine::inst().isMusicCache())
+    Dx8::SampleBank::setDiskCache(FileUtil::cacheDir(u"music"));
+  if(CommandLine::inst().isBvhCache())
+    PhysicBvh::setCacheDir(FileUtil::cacheDir(u"bvh"));
   dxMusic.reset(new Dx8::DirectMusic());
   // G2
   dxMusic->addPath(Gothic::inst().nestedPath({u"_work",u"Data",u"Music",u"newworld"},  Dir::FT_Dir));
@@ -72,9 +102,6 @@ Resources::Resources(Tempest::Device &device)
   dxMusic->addPath(Gothic::inst().nestedPath({u"_work",u"Data",u"Music",u"menu_men"}, Dir::FT_Dir));
   dxMusic->addPath(Gothic::inst().nestedPath({u"_work",u"Data",u"Music",u"orchestra"},Dir::FT_Dir));
 
-  fBuff .reserve(8*1024*1024);
-  ddsBuf.reserve(8*1024*1024);
-
   {
   Pixmap pm(1,1,TextureFormat::RGBA8);
   uint8_t* pix = reinterpret_cast<uint8_t*>(pm.data());
@@ -116,6 +143,13 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
            std::make_tuple(bIsMod,b.time,int(b.ord));
     });
 
+  if(CommandLine::inst().isTextureCache()) {
+    uint64_t stamp = 0;
+    for(auto& i:archives)
+      stamp = TextureDiskCache::archiveStamp(i.name,i.time,stamp);
+    inst->texDisk.reset(new TextureDiskCache(FileUtil::cacheDir(u"textures"),stamp));
+    }
+
   for(auto& i:archives) {
     try {
       const uint32_t UNION_VDF_VERSION = 160;
@@ -139,9 +173,10 @@ void Resources::loadVdfs(const std::vector<std::u16string>& modvdfs, bool modFil
   //for(auto& i:gothicAssets.getKnownFiles())
   //  Log::i(i);
 
-  // auto v = getFileData("DRAGONISLAND.ZEN");
+  // phoenix::buffer v = phoenix::buffer::empty();
+  // getFileView("DRAGONISLAND.ZEN",v);
   // Tempest::WFile f("../../internal/DRAGONISLAND.ZEN");
-  // f.write(v.data(),v.size());
+  // f.write(v.array(),v.limit());
   }
 
 Resources::~Resources() {
@@ -149,37 +184,18 @@ Resources::~Resources() {
   }
 
 bool Resources::hasFile(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->gothicAssets.find(name) != nullptr;
   }
 
-bool Resources::getFileData(std::string_view name, std::vector<uint8_t> &dat) {
-  dat.clear();
-
+bool Resources::getFileView(std::string_view name, phoenix::buffer& view) {
   const auto* entry = Resources::vdfsIndex().find(name);
   if(entry==nullptr)
     return false;
-
-  // TODO: This should return a buffer!
-  phoenix::buffer reader = entry->open();
-  dat.assign((uint8_t*) reader.array(), (uint8_t*) reader.array() + reader.limit());
-
+  // view into mapped archive, no copy
+  view = entry->open();
   return true;
   }
 
-std::vector<uint8_t> Resources::getFileData(std::string_view name) {
-  std::vector<uint8_t> data;
-  getFileData(name,data);
-  return data;
-  }
-
-phoenix::buffer Resources::getFileBuffer(std::string_view name) {
-  const auto* entry = Resources::vdfsIndex().find(name);
-  if (entry == nullptr)
-    throw std::runtime_error("failed to open resource: " + std::string{name});
-  return entry->open();
-  }
-
 const char* Resources::renderer() {
   return inst->dev.properties().name;
   }
@@ -276,25 +292,21 @@ int64_t Resources::vdfTimestamp(const std::u16string& name) {
     }
   }
 
-Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_view cname) {
-  if(cname.empty())
-    return nullptr;
-
-  std::string name = std::string(cname);
-  auto it=cache.find(name);
-  if(it!=cache.end())
-    return it->second.get();
-
-  if(FileExt::hasExt(name,"TGA")) {
+std::unique_ptr<Texture2d> Resources::implLoadTexture(std::string_view cname) {
+  if(FileExt::hasExt(cname,"TGA")) {
+    std::string name = std::string(cname);
     name.resize(name.size() + 2);
     std::memcpy(&name[0]+name.size()-6,"-C.TEX",6);
 
-    it=cache.find(name);
-    if(it!=cache.end())
-      return it->second.get();
-
     if(const auto* entry = Resources::vdfsIndex().find(name)) {
-      auto reader = entry->open();
+      auto   reader  = entry->open();
+      size_t srcSize = reader.limit();
+
+      // dxt is never stored in disk-cache, don't look it up
+      Tempest::Pixmap cached;
+      if(texDisk!=nullptr && !isDxtTexture(reader) && texDisk->load(name,srcSize,cached))
+        return std::make_unique<Texture2d>(dev.texture(cached));
+
       auto tex = phoenix::texture::parse(reader);
 
       if (tex.format() == phoenix::tex_dxt1 ||
@@ -304,7 +316,8 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
           tex.format() == phoenix::tex_dxt5) {
         auto dds = phoenix::texture_to_dds(tex);
 
-        auto t = implLoadTexture(cache, std::string(cname), dds);
+        // dxt is uploaded as is, nothing to save in disk-cache
+        auto t = implLoadTexture("",dds);
         if(t!=nullptr)
           return t;
         } else {
@@ -313,11 +326,9 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
         try {
           Tempest::Pixmap    pm(tex.width(), tex.height(), TextureFormat::RGBA8);
           std::memcpy(pm.data(), rgba.data(), rgba.size());
-
-          std::unique_ptr<Texture2d> t{new Texture2d(dev.texture(pm))};
-          Texture2d* ret=t.get();
-          cache[std::move(name)] = std::move(t);
-          return ret;
+          if(texDisk!=nullptr)
+            texDisk->store(name,srcSize,pm);
+          return std::make_unique<Texture2d>(dev.texture(pm));
           }
         catch (...) {
           }
@@ -327,43 +338,36 @@ Tempest::Texture2d* Resources::implLoadTexture(TextureCache& cache, std::string_
 
   if(auto* entry = Resources::vdfsIndex().find(cname)) {
     phoenix::buffer reader = entry->open();
-    return implLoadTexture(cache,std::string(cname),reader);
+    return implLoadTexture(cname,reader);
     }
 
-  cache[name]=nullptr;
   return nullptr;
   }
 
-Texture2d *Resources::implLoadTexture(TextureCache& cache, std::string&& name, const phoenix::buffer& data) {
+std::unique_ptr<Texture2d> Resources::implLoadTexture(std::string_view name, const phoenix::buffer& data) {
+  const bool useDisk = (texDisk!=nullptr && !name.empty());
   try {
-    Tempest::MemReader rd((uint8_t*)data.array(),data.limit());
-    Tempest::Pixmap    pm(rd);
+    Tempest::Pixmap pm;
+    if(useDisk && texDisk->load(name,data.limit(),pm))
+      return std::make_unique<Texture2d>(dev.texture(pm));
 
-    std::unique_ptr<Texture2d> t{new Texture2d(dev.texture(pm))};
-    Texture2d* ret=t.get();
-    cache[std::move(name)] = std::move(t);
-    return ret;
+    Tempest::MemReader rd((uint8_t*)data.array(),data.limit());
+    pm = Tempest::Pixmap(rd);
+    if(useDisk)
+      texDisk->store(name,data.limit(),pm);
+    return std::make_unique<Texture2d>(dev.texture(pm));
     }
   catch(...){
     return nullptr;
     }
   }
 
-ProtoMesh* Resources::implLoadMesh(std::string_view name) {
-  if(name.size()==0)
-    return nullptr;
-
+std::unique_ptr<ProtoMesh> Resources::implLoadMesh(std::string_view name) {
   auto cname = std::string(name);
-  auto it    = aniMeshCache.find(cname);
-  if(it!=aniMeshCache.end())
-    return it->second.get();
-
-  auto  t   = implLoadMeshMain(cname);
-  auto  ret = t.get();
-  aniMeshCache[cname] = std::move(t);
-  if(ret==nullptr)
+  auto t     = implLoadMeshMain(cname);
+  if(t==nullptr)
     Log::e("unable to load mesh \"",cname,"\"");
-  return ret;
+  return t;
   }
 
 std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
@@ -411,20 +415,16 @@ std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
     FileExt::exchangeExt(mesh,nullptr,"MDM") ||
     FileExt::exchangeExt(mesh,"ASC",  "MDM");
 
-    if(hasFile(mesh)) {
-      const auto* entry = Resources::vdfsIndex().find(mesh);
-      auto reader = entry->open();
+    auto reader = phoenix::buffer::empty();
+    if(getFileView(mesh,reader))
       mdm = phoenix::model_mesh::parse(reader);
-      }
 
     if(anim->defaultMesh().empty())
       mesh = name;
     FileExt::assignExt(mesh,"MDH");
 
-    const auto* entry = Resources::vdfsIndex().find(mesh);
-    if(entry==nullptr)
+    if(!getFileView(mesh,reader))
       throw std::runtime_error("failed to open resource: " + mesh);
-    auto reader = entry->open();
     auto mdh = phoenix::model_hierarchy::parse(reader);
 
     std::unique_ptr<Skeleton> sk{new Skeleton(mdh,anim,name)};
@@ -439,27 +439,20 @@ std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
   if(FileExt::hasExt(name,"MDM") || FileExt::hasExt(name,"ASC")) {
     FileExt::exchangeExt(name,"ASC","MDM");
 
-    if(!hasFile(name))
+    auto reader = phoenix::buffer::empty();
+    if(!getFileView(name,reader))
       return nullptr;
 
-    const auto* entry = Resources::vdfsIndex().find(name);
-    if(entry == nullptr)
-      return nullptr;
-
-    auto reader = entry->open();
     auto mdm = phoenix::model_mesh::parse(reader);
     std::unique_ptr<ProtoMesh> t{new ProtoMesh(std::move(mdm),nullptr,name)};
     return t;
     }
 
   if(FileExt::hasExt(name,"MDL")) {
-    if(!hasFile(name))
+    auto reader = phoenix::buffer::empty();
+    if(!getFileView(name,reader))
       return nullptr;
 
-    const auto* entry = Resources::vdfsIndex().find(name);
-    if(entry == nullptr)
-      throw std::runtime_error("failed to open resource: " + name);
-    auto reader = entry->open();
     auto mdm = phoenix::model::parse(reader);
 
     std::unique_ptr<Skeleton> sk{new Skeleton(mdm.hierarchy,nullptr,name)};
@@ -474,14 +467,9 @@ std::unique_ptr<ProtoMesh> Resources::implLoadMeshMain(std::string name) {
   return nullptr;
   }
 
-PfxEmitterMesh* Resources::implLoadEmiterMesh(std::string_view name) {
+std::unique_ptr<PfxEmitterMesh> Resources::implLoadEmiterMesh(std::string_view name) {
   // TODO: reuse code from Resources::implLoadMeshMain
   auto cname = std::string(name);
-  auto it    = emiMeshCache.find(cname);
-  if(it!=emiMeshCache.end())
-    return it->second.get();
-
-  auto& ret = emiMeshCache[cname];
 
   if(FileExt::hasExt(cname,"3DS")) {
     FileExt::exchangeExt(cname,"3DS","MRM");
@@ -495,41 +483,22 @@ PfxEmitterMesh* Resources::implLoadEmiterMesh(std::string_view name) {
       return nullptr;
 
     PackedMesh packed(zmsh,PackedMesh::PK_Visual);
-    ret = std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(packed));
-    return ret.get();
+    return std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(packed));
     }
 
   if(FileExt::hasExt(name,"MDM")) {
-    if(!hasFile(name))
+    auto reader = phoenix::buffer::empty();
+    if(!getFileView(cname,reader))
       return nullptr;
 
-    const auto* entry = Resources::vdfsIndex().find(cname);
-    if(entry == nullptr)
-      throw std::runtime_error("failed to open resource: " + cname);
-    auto reader = entry->open();
     auto mdm = phoenix::model_mesh::parse(reader);
-
-    ret = std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(std::move(mdm)));
-    return ret.get();
+    return std::unique_ptr<PfxEmitterMesh>(new PfxEmitterMesh(std::move(mdm)));
     }
 
   return nullptr;
   }
 
-ProtoMesh* Resources::implDecalMesh(const phoenix::vob& vob) {
-  DecalK key;
-  key.mat         = Material(vob);
-  key.sX          = vob.visual_decal->dimension.x;
-  key.sY          = vob.visual_decal->dimension.y;
-  key.decal2Sided = vob.visual_decal->two_sided;
-
-  if(key.mat.tex==nullptr)
-    return nullptr;
-
-  auto it = decalMeshCache.find(key);
-  if(it!=decalMeshCache.end())
-    return it->second.get();
-
+std::unique_ptr<ProtoMesh> Resources::implDecalMesh(const DecalK& key) {
   Resources::Vertex vbo[8] = {
     {{-1.f, -1.f, 0.f},{0,0,-1},{0,1}, 0xFFFFFFFF},
     {{ 1.f, -1.f, 0.f},{0,0,-1},{1,1}, 0xFFFFFFFF},
@@ -552,11 +521,7 @@ ProtoMesh* Resources::implDecalMesh(const phoenix::vob& vob) {
     cibo = { 0,1,2, 0,2,3, 4,6,5, 4,7,6 }; else
     cibo = { 0,1,2, 0,2,3 };
 
-  std::unique_ptr<ProtoMesh> t{new ProtoMesh(key.mat, std::move(cvbo), std::move(cibo))};
-
-  auto ret = t.get();
-  decalMeshCache[key] = std::move(t);
-  return ret;
+  return std::unique_ptr<ProtoMesh>{new ProtoMesh(key.mat, std::move(cvbo), std::move(cibo))};
   }
 
 std::unique_ptr<Animation> Resources::implLoadAnimation(std::string name) {
@@ -584,6 +549,7 @@ std::unique_ptr<Animation> Resources::implLoadAnimation(std::string name) {
   }
 
 Dx8::PatternList Resources::implLoadDxMusic(std::string_view name) {
+  std::lock_guard<std::mutex> g(syncMusic);
   auto u = Tempest::TextCodec::toUtf16(std::string(name));
   return dxMusic->load(u.c_str());
   }
@@ -592,10 +558,11 @@ Tempest::Sound Resources::implLoadSoundBuffer(std::string_view name) {
   if(name.empty())
     return Tempest::Sound();
 
-  if(!getFileData(name,fBuff))
+  auto data = phoenix::buffer::empty();
+  if(!getFileView(name,data))
     return Tempest::Sound();
   try {
-    Tempest::MemReader rd(fBuff.data(),fBuff.size());
+    Tempest::MemReader rd((uint8_t*)data.array(),data.limit());
     return Tempest::Sound(rd);
     }
   catch(...) {
@@ -663,28 +630,39 @@ GthFont &Resources::implLoadFont(std::string_view name, FontType type) {
   return *f;
   }
 
-const Texture2d *Resources::loadTexture(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadTexture(inst->texCache,name);
+const Texture2d *Resources::loadTexture(std::string_view name, bool world) {
+  if(name.empty())
+    return nullptr;
+  return inst->texCache.get(std::string(name),[name](){
+    return inst->implLoadTexture(name);
+    },!world);
   }
 
-const Texture2d* Resources::loadTexture(Tempest::Color color) {
+const Texture2d* Resources::loadTexture(Tempest::Color color, bool world) {
   if(color==Color())
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  auto& cache = inst->pixCache;
-  auto it = cache.find(color);
-  if(it!=cache.end())
-    return it->second.get();
-
-  uint8_t iv[4] = { uint8_t(255.f*color.r()), uint8_t(255.f*color.g()), uint8_t(255.f*color.b()), uint8_t(255.f*color.a()) };
-  Pixmap p2(1,1,TextureFormat::RGBA8);
-  std::memcpy(p2.data(),iv,4);
-
-  auto t       = std::make_unique<Texture2d>(inst->dev.texture(p2));
-  auto ret     = t.get();
-  cache[color] = std::move(t);
-  return ret;
+  return inst->pixCache.get(color,[color](){
+    uint8_t iv[4] = { uint8_t(255.f*color.r()), uint8_t(255.f*color.g()), uint8_t(255.f*color.b()), uint8_t(255.f*color.a()) };
+    Pixmap p2(1,1,TextureFormat::RGBA8);
+    std::memcpy(p2.data(),iv,4);
+    return std::make_unique<Texture2d>(inst->dev.texture(p2));
+    },!world);
+  }
+
+Workers::Task Resources::loadTextureAsync(std::string_view name) {
+  Texture2d* ret = nullptr;
+  if(name.empty() || inst->texCache.find(std::string(name),ret))
+    return Workers::Task();
+  return Workers::spawn([cname = std::string(name)](){
+    try {
+      // speculative load: don't keep misses; preloads are world assets
+      if(loadTexture(cname,true)==nullptr)
+        inst->texCache.eraseNull(cname);
+      }
+    catch(...) {
+      // reported by loader; entry is retried on next synchronous load
+      }
+    });
   }
 
 const Texture2d *Resources::loadTexture(std::string_view name, int32_t iv, int32_t ic) {
@@ -709,7 +687,7 @@ const Texture2d *Resources::loadTexture(std::string_view name, int32_t iv, int32
   return loadTexture(buf1);
   }
 
-std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name) {
+std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name, bool world) {
   std::vector<const Texture2d*> ret;
   if(name.find("_A0")==std::string::npos &&
      name.find("_a0")==std::string::npos)
@@ -731,10 +709,10 @@ std::vector<const Texture2d*> Resources::loadTextureAnim(std::string_view name)
       if(at>sizeof(buf))
         return ret;
       }
-   auto t = loadTexture(buf);
+   auto t = loadTexture(buf,world);
     if(t==nullptr) {
       string_frm buf2(buf,".TGA");
-      t = loadTexture(buf2);
+      t = loadTexture(buf2,world);
       if(t==nullptr)
         return ret;
       }
@@ -758,15 +736,33 @@ Material Resources::loadMaterial(const phoenix::material& src, bool enableAlphaT
 const ProtoMesh* Resources::loadMesh(std::string_view name) {
   if(name.size()==0)
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadMesh(name);
+  return inst->aniMeshCache.get(std::string(name),[name](){
+    return inst->implLoadMesh(name);
+    });
+  }
+
+Workers::Task Resources::loadMeshAsync(std::string_view name) {
+  ProtoMesh* ret = nullptr;
+  if(name.empty() || inst->aniMeshCache.find(std::string(name),ret))
+    return Workers::Task();
+  return Workers::spawn([cname = std::string(name)](){
+    try {
+      // speculative load: don't keep misses
+      if(loadMesh(cname)==nullptr)
+        inst->aniMeshCache.eraseNull(cname);
+      }
+    catch(...) {
+      // reported by loader; entry is retried on next synchronous load
+      }
+    });
   }
 
 const PfxEmitterMesh* Resources::loadEmiterMesh(std::string_view name) {
   if(name.empty())
     return nullptr;
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadEmiterMesh(name);
+  return inst->emiMeshCache.get(std::string(name),[name](){
+    return inst->implLoadEmiterMesh(name);
+    });
   }
 
 const Skeleton* Resources::loadSkeleton(std::string_view name) {
@@ -778,43 +774,42 @@ const Skeleton* Resources::loadSkeleton(std::string_view name) {
 
 const Animation* Resources::loadAnimation(std::string_view name) {
   auto cname = std::string(name);
-
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  auto& cache = inst->animCache;
-  auto it=cache.find(cname);
-  if(it!=cache.end())
-    return it->second.get();
-  auto t       = inst->implLoadAnimation(cname);
-  auto ret     = t.get();
-  cache[cname] = std::move(t);
-  return ret;
+  return inst->animCache.get(cname,[&cname](){
+    return inst->implLoadAnimation(cname);
+    });
   }
 
 Tempest::Sound Resources::loadSoundBuffer(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadSoundBuffer(name);
   }
 
 Dx8::PatternList Resources::loadDxMusic(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
   return inst->implLoadDxMusic(name);
   }
 
 const ProtoMesh* Resources::decalMesh(const phoenix::vob& vob) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implDecalMesh(vob);
+  DecalK key;
+  key.mat         = Material(vob);
+  key.sX          = vob.visual_decal->dimension.x;
+  key.sY          = vob.visual_decal->dimension.y;
+  key.decal2Sided = vob.visual_decal->two_sided;
+
+  if(key.mat.tex==nullptr)
+    return nullptr;
+
+  return inst->decalMeshCache.get(key,[&key](){
+    return inst->implDecalMesh(key);
+    });
   }
 
 const Resources::VobTree* Resources::loadVobBundle(std::string_view name) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
-  return inst->implLoadVobBundle(name);
+  return inst->zenCache.get(std::string(name),[name](){
+    return inst->implLoadVobBundle(name);
+    });
   }
 
-const Resources::VobTree* Resources::implLoadVobBundle(std::string_view filename) {
+std::unique_ptr<Resources::VobTree> Resources::implLoadVobBundle(std::string_view filename) {
   auto cname = std::string(filename);
-  auto i     = zenCache.find(cname);
-  if(i!=zenCache.end())
-    return i->second.get();
 
   std::vector<std::unique_ptr<phoenix::vob>> bundle;
   try {
@@ -831,27 +826,138 @@ const Resources::VobTree* Resources::implLoadVobBundle(std::string_view filename
     Log::e("unable to load Zen-file: \"",cname,"\"");
     }
 
-  auto ret = zenCache.insert(std::make_pair(filename,std::make_unique<VobTree>(std::move(bundle))));
-  return ret.first->second.get();
+  return std::make_unique<VobTree>(std::move(bundle));
   }
 
-const AttachBinder *Resources::bindMesh(const ProtoMesh &anim, const Skeleton &s) {
-  std::lock_guard<std::recursive_mutex> g(inst->sync);
+std::vector<Resources::CacheStats> Resources::cacheStats() {
+  std::vector<CacheStats> ret;
+  ret.push_back(inst->texCache      .stats("texture"));
+  ret.push_back(inst->pixCache      .stats("color"));
+  ret.push_back(inst->aniMeshCache  .stats("mesh"));
+  ret.push_back(inst->decalMeshCache.stats("decal"));
+  ret.push_back(inst->animCache     .stats("animation"));
+  ret.push_back(inst->bindCache     .stats("binder"));
+  ret.push_back(inst->emiMeshCache  .stats("emitter",true));
+  ret.push_back(inst->zenCache      .stats("vob-bundle"));
+  return ret;
+  }
+
+static void collectTextures(const Material& m, std::unordered_set<const void*>& out) {
+  out.insert(m.tex);
+  for(auto t:m.frames)
+    out.insert(t);
+  }
+
+static void collectTextures(const ProtoMesh& m, std::unordered_set<const void*>& out) {
+  for(auto& a:m.attach)
+    for(auto& s:a.sub)
+      collectTextures(s.material,out);
+  for(auto& a:m.skined)
+    for(auto& s:a.sub)
+      collectTextures(s.material,out);
+  }
 
+void Resources::evictUnused(size_t budget) {
+  // Textures requested by ui and global particle/vfx definitions are pinned; emitter-meshes are referenced by
+  // session-wide vfx definitions, so that cache is not evicted at all.
+  assert(Gothic::inst().world()==nullptr);
+  auto& r = *inst;
+
+  std::vector<std::pair<uint64_t,size_t>> usage;
+  auto collect = [&usage](const void*, uint64_t lastUse, size_t bytes){
+    usage.emplace_back(lastUse,bytes);
+    };
+  r.texCache      .forEach(collect);
+  r.aniMeshCache  .forEach(collect);
+  r.decalMeshCache.forEach(collect);
+  r.animCache     .forEach(collect);
+  r.zenCache      .forEach(collect);
+
+  std::sort(usage.begin(),usage.end(),[](const std::pair<uint64_t,size_t>& a, const std::pair<uint64_t,size_t>& b){
+    return a.first>b.first;
+    });
+
+  uint64_t threshold = 0;
+  size_t   resident  = 0;
+  for(auto& i:usage) {
+    resident += i.second;
+    if(resident>budget) {
+      threshold = i.first+1;
+      break;
+      }
+    }
+
+  auto lru = [threshold](const void*, uint64_t lastUse){ return lastUse<threshold; };
+  r.aniMeshCache  .evictIf(lru);
+  r.decalMeshCache.evictIf(lru);
+  r.zenCache      .evictIf(lru);
+  // binders are keyed by mesh pointer, and cheap to rebuild
+  r.bindCache     .evictIf([](const void*, uint64_t){ return true; });
+
+  // skeletons of resident meshes point to animations
+  std::unordered_set<const Animation*> inUse;
+  r.aniMeshCache.forEach([&inUse](const ProtoMesh* m, uint64_t, size_t){
+    if(m!=nullptr && m->skeleton!=nullptr)
+      inUse.insert(m->skeleton->animation());
+    });
+  r.animCache.evictIf([threshold,&inUse](const Animation* a, uint64_t lastUse){
+    return lastUse<threshold && inUse.find(a)==inUse.end();
+    });
+
+  // materials of resident meshes point to textures
+  std::unordered_set<const void*> texInUse;
+  auto meshTex = [&texInUse](const ProtoMesh* m, uint64_t, size_t){
+    if(m!=nullptr)
+      collectTextures(*m,texInUse);
+    };
+  r.aniMeshCache  .forEach(meshTex);
+  r.decalMeshCache.forEach(meshTex);
+  r.texCache.evictIf([threshold,&texInUse](const Texture2d* t, uint64_t lastUse){
+    return lastUse<threshold && texInUse.find(t)==texInUse.end();
+    });
+  // 1x1 color textures: not accounted in budget, drop all unreferenced ones
+  r.pixCache.evictIf([&texInUse](const Texture2d* t, uint64_t){
+    return texInUse.find(t)==texInUse.end();
+    });
+
+  for(auto& i:cacheStats())
+    Log::i("resources: ",i.name," count=",i.count," size=",i.bytes/1024,"Kb pinned=",i.pinned);
+  }
+
+size_t Resources::memoryUsage(const Tempest::Texture2d& t) {
+  // upper estimate: mip-chain and block compression are not accounted
+  return size_t(t.w())*size_t(t.h())*4;
+  }
+
+size_t Resources::memoryUsage(const ProtoMesh& m) {
+  return m.memoryUsage();
+  }
+
+size_t Resources::memoryUsage(const Animation& a) {
+  return a.memoryUsage();
+  }
+
+size_t Resources::memoryUsage(const AttachBinder& b) {
+  return sizeof(b) + b.bind.size()*sizeof(size_t);
+  }
+
+size_t Resources::memoryUsage(const PfxEmitterMesh& m) {
+  return m.memoryUsage();
+  }
+
+size_t Resources::memoryUsage(const VobTree& v) {
+  return v.size()*sizeof(phoenix::vob);
+  }
+
+const AttachBinder *Resources::bindMesh(const ProtoMesh &anim, const Skeleton &s) {
   if(anim.submeshId.size()==0){
     static AttachBinder empty;
     return &empty;
     }
   BindK k = BindK(&s,&anim);
-
-  auto it = inst->bindCache.find(k);
-  if(it!=inst->bindCache.end())
-    return it->second.get();
-
-  std::unique_ptr<AttachBinder> ret(new AttachBinder(s,anim));
-  auto p = ret.get();
-  inst->bindCache[k] = std::move(ret);
-  return p;
+  return inst->bindCache.get(k,[&anim,&s](){
+    return std::unique_ptr<AttachBinder>(new AttachBinder(s,anim));
+    });
   }
 
 Tempest::VertexBuffer<Resources::Vertex> Resources::sphere(int passCount, float R){
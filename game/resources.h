@@ -11,10 +11,15 @@
 #include <tuple>
 #include <string_view>
 #include <map>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "graphics/material.h"
 #include "phoenix/Vfs.hh"
 #include "sound/soundfx.h"
+#include "utils/workers.h"
 
 class StaticMesh;
 class ProtoMesh;
@@ -24,6 +29,7 @@ class AttachBinder;
 class PhysicMeshShape;
 class PfxEmitterMesh;
 class GthFont;
+class TextureDiskCache;
 
 namespace Dx8 {
 class DirectMusic;
@@ -92,15 +98,19 @@ class Resources final {
 
     static const Tempest::Texture2d& fallbackTexture();
     static const Tempest::Texture2d& fallbackBlack();
-    static const Tempest::Texture2d* loadTexture(std::string_view name);
-    static const Tempest::Texture2d* loadTexture(Tempest::Color color);
+    // 'world': texture is only referenced by world objects and meshes, evictUnused may drop it after world teardown;
+    // any request without the flag pins texture for the whole session
+    static const Tempest::Texture2d* loadTexture(std::string_view name, bool world = false);
+    static const Tempest::Texture2d* loadTexture(Tempest::Color color, bool world = false);
     static const Tempest::Texture2d* loadTexture(std::string_view name, int32_t v, int32_t c);
+    static Workers::Task             loadTextureAsync(std::string_view name);
     static       Tempest::Texture2d  loadTexturePm(const Tempest::Pixmap& pm);
-    static auto                      loadTextureAnim(std::string_view name) -> std::vector<const Tempest::Texture2d*>;
+    static auto                      loadTextureAnim(std::string_view name, bool world = false) -> std::vector<const Tempest::Texture2d*>;
     static       Material            loadMaterial(const phoenix::material& src, bool enableAlphaTest);
 
     static const AttachBinder*       bindMesh       (const ProtoMesh& anim, const Skeleton& s);
     static const ProtoMesh*          loadMesh       (std::string_view name);
+    static Workers::Task             loadMeshAsync  (std::string_view name);
     static const PfxEmitterMesh*     loadEmiterMesh (std::string_view name);
     static const Skeleton*           loadSkeleton   (std::string_view name);
     static const Animation*          loadAnimation  (std::string_view name);
@@ -111,6 +121,16 @@ class Resources final {
 
     static const VobTree*            loadVobBundle(std::string_view name);
 
+    struct CacheStats {
+      const char* name  = "";
+      size_t      count = 0;
+      size_t      bytes = 0;
+      size_t      pinned = 0; // entries, not subject to evictUnused
+      };
+    static auto                      cacheStats() -> std::vector<CacheStats>;
+    // drops least recently used world assets above budget; call only when no world is alive
+    static void                      evictUnused(size_t budget);
+
     template<class V>
     static Tempest::VertexBuffer<V>  vbo(const V* data,size_t sz){ return inst->dev.vbo(data,sz); }
 
@@ -129,9 +149,7 @@ class Resources final {
       return inst->dev.blas(b,i,offset,size);
       }
 
-    static std::vector<uint8_t>      getFileData(std::string_view name);
-    static bool                      getFileData(std::string_view name, std::vector<uint8_t>& dat);
-    static phoenix::buffer           getFileBuffer(std::string_view name);
+    static bool                      getFileView(std::string_view name, phoenix::buffer& view);
     static bool                      hasFile    (std::string_view fname);
 
     static const phoenix::Vfs&       vdfsIndex();
@@ -161,22 +179,150 @@ class Resources final {
         }
       };
 
-    using TextureCache = std::unordered_map<std::string,std::unique_ptr<Tempest::Texture2d>>;
+    static std::atomic<uint64_t> useTick;
+
+    // Each cache has its own lock; loading is done outside of lock, so different assets can be loaded in parallel.
+    // Concurrent requests for the same key wait for the first one (single-flight).
+    template<class K, class V, class H = std::hash<K>>
+    class Cache {
+      public:
+        // 'pin' marks entry as session-wide: evictIf never drops it
+        template<class F>
+        V* get(const K& key, const F& load, bool pin = false) {
+          std::unique_lock<std::mutex> lck(sync);
+          while(true) {
+            auto ins = data.try_emplace(key);
+            if(ins.second)
+              break;
+            // someone else is loading this asset already
+            cv.wait(lck,[&](){
+              auto it = data.find(key);
+              return it==data.end() || it->second.ready;
+              });
+            auto it = data.find(key);
+            if(it!=data.end()) {
+              it->second.lastUse = useTick.fetch_add(1);
+              it->second.pinned |= pin;
+              return it->second.val.get();
+              }
+            // loader failed with exception - try again
+            }
+          lck.unlock();
+
+          std::unique_ptr<V> val;
+          size_t             bytes = 0;
+          try {
+            val = load();
+            if(val!=nullptr)
+              bytes = memoryUsage(*val);
+            }
+          catch(...) {
+            lck.lock();
+            data.erase(key);
+            cv.notify_all();
+            throw;
+            }
+
+          lck.lock();
+          auto& e   = data[key];
+          e.val     = std::move(val);
+          e.bytes   = bytes;
+          e.lastUse = useTick.fetch_add(1);
+          e.pinned |= pin;
+          e.ready   = true;
+          total    += bytes;
+          cv.notify_all();
+          return e.val.get();
+          }
+
+        // f(value, lastUse, bytes); unpinned entries only
+        template<class F>
+        void forEach(const F& f) {
+          std::lock_guard<std::mutex> g(sync);
+          for(auto& i:data)
+            if(i.second.ready && !i.second.pinned)
+              f(i.second.val.get(),i.second.lastUse,i.second.bytes);
+          }
+
+        // erases unpinned entries, where pred(value, lastUse) is true
+        template<class P>
+        void evictIf(const P& pred) {
+          std::lock_guard<std::mutex> g(sync);
+          for(auto it=data.begin(); it!=data.end();) {
+            auto& e = it->second;
+            if(e.ready && !e.pinned && pred(e.val.get(),e.lastUse)) {
+              total -= e.bytes;
+              it = data.erase(it);
+              } else {
+              ++it;
+              }
+            }
+          }
+
+        CacheStats stats(const char* name, bool pinned = false) {
+          std::lock_guard<std::mutex> g(sync);
+          CacheStats st;
+          st.name   = name;
+          st.count  = data.size();
+          st.bytes  = total;
+          for(auto& i:data)
+            if(pinned || i.second.pinned)
+              st.pinned++;
+          return st;
+          }
+
+        // drops failed (nullptr) entry, so next request loads it again
+        void eraseNull(const K& key) {
+          std::lock_guard<std::mutex> g(sync);
+          auto it = data.find(key);
+          if(it!=data.end() && it->second.ready && it->second.val==nullptr)
+            data.erase(it);
+          }
+
+        bool find(const K& key, V*& ret) {
+          std::lock_guard<std::mutex> g(sync);
+          auto it = data.find(key);
+          if(it==data.end() || !it->second.ready)
+            return false;
+          ret = it->second.val.get();
+          return true;
+          }
+
+      private:
+        struct Entry {
+          std::unique_ptr<V> val;
+          size_t             bytes   = 0;
+          uint64_t           lastUse = 0;
+          bool               pinned  = false;
+          bool               ready   = false;
+          };
+        std::mutex                    sync;
+        std::condition_variable       cv;
+        std::unordered_map<K,Entry,H> data;
+        size_t                        total = 0;
+      };
+
+    static size_t         memoryUsage(const Tempest::Texture2d& t);
+    static size_t         memoryUsage(const ProtoMesh& m);
+    static size_t         memoryUsage(const Animation& a);
+    static size_t         memoryUsage(const AttachBinder& b);
+    static size_t         memoryUsage(const PfxEmitterMesh& m);
+    static size_t         memoryUsage(const VobTree& v);
 
     int64_t               vdfTimestamp(const std::u16string& name);
     void                  detectVdf(std::vector<Archive>& ret, const std::u16string& root);
 
-    Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string_view cname);
-    Tempest::Texture2d*   implLoadTexture(TextureCache& cache, std::string &&name, const phoenix::buffer& data);
-    ProtoMesh*            implLoadMesh(std::string_view name);
+    std::unique_ptr<Tempest::Texture2d> implLoadTexture(std::string_view cname);
+    std::unique_ptr<Tempest::Texture2d> implLoadTexture(std::string_view name, const phoenix::buffer& data);
+    std::unique_ptr<ProtoMesh> implLoadMesh(std::string_view name);
     std::unique_ptr<ProtoMesh> implLoadMeshMain(std::string name);
     std::unique_ptr<Animation> implLoadAnimation(std::string name);
-    ProtoMesh*            implDecalMesh(const phoenix::vob& vob);
+    std::unique_ptr<ProtoMesh> implDecalMesh(const DecalK& key);
     Tempest::Sound        implLoadSoundBuffer(std::string_view name);
     Dx8::PatternList      implLoadDxMusic(std::string_view name);
     GthFont&              implLoadFont(std::string_view fname, FontType type);
-    PfxEmitterMesh*       implLoadEmiterMesh(std::string_view name);
-    const VobTree*        implLoadVobBundle(std::string_view name);
+    std::unique_ptr<PfxEmitterMesh> implLoadEmiterMesh(std::string_view name);
+    std::unique_ptr<VobTree> implLoadVobBundle(std::string_view name);
 
     Tempest::VertexBuffer<Vertex> sphere(int passCount, float R);
 
@@ -196,35 +342,32 @@ class Resources final {
         std::hash<std::string> h;
         return h(std::get<0>(b));
         }
-      };
-
-    struct Less {
-      size_t operator()(const Tempest::Color& a, const Tempest::Color& b) const {
-        auto ta = std::make_tuple(a.r(),a.g(),a.b(),a.a());
-        auto tb = std::make_tuple(b.r(),b.g(),b.b(),b.a());
-        return ta<tb;
+      size_t operator()(const Tempest::Color& c) const {
+        uint32_t v = 0;
+        for(float f:{c.r(),c.g(),c.b(),c.a()})
+          v = v*31 + uint32_t(f*255.f);
+        return v;
         }
       };
 
     Tempest::Device&                  dev;
     Tempest::SoundDevice              sound;
 
-    std::recursive_mutex              sync;
+    std::mutex                        syncMusic;
     std::unique_ptr<Dx8::DirectMusic> dxMusic;
     phoenix::Vfs                      gothicAssets;
+    std::unique_ptr<TextureDiskCache> texDisk;
 
-    std::vector<uint8_t>              fBuff, ddsBuf;
     Tempest::VertexBuffer<VertexFsq>  fsq;
 
-    TextureCache                                                      texCache;
-    std::map<Tempest::Color,std::unique_ptr<Tempest::Texture2d>,Less> pixCache;
-    std::unordered_map<std::string,std::unique_ptr<ProtoMesh>>        aniMeshCache;
-    std::unordered_map<DecalK,std::unique_ptr<ProtoMesh>,Hash>        decalMeshCache;
-    std::unordered_map<std::string,std::unique_ptr<Skeleton>>         skeletonCache;
-    std::unordered_map<std::string,std::unique_ptr<Animation>>        animCache;
-    std::unordered_map<BindK,std::unique_ptr<AttachBinder>,Hash>      bindCache;
-    std::unordered_map<std::string,std::unique_ptr<PfxEmitterMesh>>   emiMeshCache;
-    std::unordered_map<std::string,std::unique_ptr<VobTree>>          zenCache;
+    Cache<std::string,Tempest::Texture2d>                             texCache;
+    Cache<Tempest::Color,Tempest::Texture2d,Hash>                     pixCache;
+    Cache<std::string,ProtoMesh>                                      aniMeshCache;
+    Cache<DecalK,ProtoMesh,Hash>                                      decalMeshCache;
+    Cache<std::string,Animation>                                      animCache;
+    Cache<BindK,AttachBinder,Hash>                                    bindCache;
+    Cache<std::string,PfxEmitterMesh>                                 emiMeshCache;
+    Cache<std::string,VobTree>                                        zenCache;
 
     std::recursive_mutex                                              syncFont;
     std::unordered_map<FontK,std::unique_ptr<GthFont>,Hash>           gothicFnt;
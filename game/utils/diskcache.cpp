@@ -0,0 +1,134 @@
+#include "diskcache.h"
+
+#include <Tempest/File>
+#include <Tempest/Log>
+
+#include <filesystem>
+#include <stdexcept>
+#include <cstring>
+
+#include "utils/fileutil.h"
+#include "utils/fnvhash.h"
+
+using namespace Tempest;
+
+DiskCache::DiskCache(std::u16string d, const char* tag, const char16_t* ext, const char (&mg)[5], uint32_t version)
+  :dir(std::move(d)), tag(tag), ext(ext), version(version) {
+  std::memcpy(magic,mg,sizeof(magic));
+  if(dir.empty())
+    return;
+  if(dir.back()!='/')
+    dir.push_back('/');
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(dir),ec);
+  if(ec) {
+    Log::e(tag,": unable to create cache directory");
+    dir.clear();
+    }
+  }
+
+bool DiskCache::load(uint64_t key, void* meta, size_t metaSize, const std::function<void*(size_t)>& alloc) const {
+  if(dir.empty())
+    return false;
+  auto file = path(key);
+  if(!FileUtil::exists(file))
+    return false;
+
+  try {
+    RFile        fin(file);
+    const size_t fsize = fin.size();
+    Header       hdr;
+    if(fin.read(&hdr,sizeof(hdr))!=sizeof(hdr))
+      return false;
+    if(std::memcmp(hdr.magic,magic,sizeof(magic))!=0 || hdr.version!=version)
+      return false;
+    if(hdr.key!=key || hdr.metaSize!=metaSize)
+      return false;
+    if(hdr.dataSize!=fsize-sizeof(hdr)-metaSize) {
+      // truncated or garbage size - reject before allocating anything
+      Log::e(tag,": corrupted entry");
+      remove(file);
+      return false;
+      }
+    if(fin.read(meta,metaSize)!=metaSize)
+      return false;
+
+    const size_t size = size_t(hdr.dataSize);
+    void*        data = alloc(size);
+    if(data==nullptr)
+      return false;
+    if(fin.read(data,size)!=size || checksum(meta,metaSize,data,size)!=hdr.checksum) {
+      Log::e(tag,": corrupted entry");
+      remove(file);
+      return false;
+      }
+    return true;
+    }
+  catch(...) {
+    return false;
+    }
+  }
+
+bool DiskCache::store(uint64_t key, const void* meta, size_t metaSize, const void* data, size_t dataSize) const {
+  if(dir.empty())
+    return false;
+
+  Header hdr;
+  std::memcpy(hdr.magic,magic,sizeof(magic));
+  hdr.version  = version;
+  hdr.key      = key;
+  hdr.metaSize = metaSize;
+  hdr.dataSize = dataSize;
+  hdr.checksum = checksum(meta,metaSize,data,dataSize);
+
+  // write to temporary file first, so a crash never leaves half-written entry behind
+  auto file = path(key);
+  auto tmp  = file;
+  for(auto c:std::to_string(tmpId.fetch_add(1)))
+    tmp.push_back(char16_t(c));
+  tmp += u".tmp";
+
+  try {
+    {
+    WFile fout(tmp);
+    bool  ok = fout.write(&hdr,sizeof(hdr))==sizeof(hdr) &&
+               fout.write(meta,metaSize)==metaSize &&
+               fout.write(data,dataSize)==dataSize;
+    fout.flush();
+    if(!ok)
+      throw std::runtime_error("write error");
+    }
+    std::error_code ec;
+    std::filesystem::rename(std::filesystem::path(tmp),std::filesystem::path(file),ec);
+    if(ec) {
+      remove(tmp);
+      return false;
+      }
+    return true;
+    }
+  catch(...) {
+    remove(tmp);
+    return false;
+    }
+  }
+
+std::u16string DiskCache::path(uint64_t key) const {
+  static const char16_t hex[] = u"0123456789ABCDEF";
+  std::u16string ret = dir;
+  for(int i=15; i>=0; --i)
+    ret.push_back(hex[(key>>(i*4))&0xF]);
+  ret += ext;
+  return ret;
+  }
+
+void DiskCache::remove(const std::u16string& file) {
+  std::error_code ec;
+  std::filesystem::remove(std::filesystem::path(file),ec);
+  }
+
+uint64_t DiskCache::checksum(const void* meta, size_t metaSize, const void* data, size_t dataSize) {
+  uint64_t h = FnvHash::basis;
+  h = FnvHash::bytes(h,meta,metaSize);
+  h = FnvHash::bytes(h,data,dataSize);
+  return h;
+  }
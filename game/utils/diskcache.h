@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Directory of checksummed binary entries, keyed by 64-bit hash.
+// Entry layout: Header | meta | payload. 'meta' is a caller-defined fixed-size struct.
+class DiskCache final {
+  public:
+    DiskCache(std::u16string dir, const char* tag, const char16_t* ext, const char (&magic)[5], uint32_t version);
+    DiskCache(const DiskCache&)=delete;
+
+    bool isOpen() const { return !dir.empty(); }
+
+    // reads 'meta' of entry; alloc(dataSize) validates meta and returns storage for payload, or nullptr to reject entry
+    bool load (uint64_t key, void* meta, size_t metaSize, const std::function<void*(size_t)>& alloc) const;
+    bool store(uint64_t key, const void* meta, size_t metaSize, const void* data, size_t dataSize) const;
+
+  private:
+    struct Header {
+      char     magic[4] = {};
+      uint32_t version  = 0;
+      uint64_t key      = 0;
+      uint64_t metaSize = 0;
+      uint64_t dataSize = 0;
+      uint64_t checksum = 0;
+      };
+
+    std::u16string  path(uint64_t key) const;
+    static void     remove(const std::u16string& file);
+    static uint64_t checksum(const void* meta, size_t metaSize, const void* data, size_t dataSize);
+
+    std::u16string                dir;
+    const char*                   tag      = "";
+    const char16_t*               ext      = u"";
+    char                          magic[4] = {};
+    uint32_t                      version  = 0;
+    mutable std::atomic<uint32_t> tmpId{0};
+  };
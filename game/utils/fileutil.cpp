@@ -10,6 +10,8 @@
 #include <sys/stat.h>
 #endif
 
+#include <cstdlib>
+
 using namespace Tempest;
 
 bool FileUtil::exists(const std::u16string &path) {
@@ -61,3 +63,30 @@ std::u16string FileUtil::nestedPath(std::u16string_view gpath, const std::initia
     path = caseInsensitiveSegment(path,segment, (segment==*(name.end()-1)) ? type : Dir::FT_Dir);
   return path;
   }
+
+std::u16string FileUtil::cacheDir(const char16_t* sub) {
+  std::u16string root;
+#if defined(__WINDOWS__)
+  if(auto v = _wgetenv(L"LOCALAPPDATA"))
+    root = reinterpret_cast<const char16_t*>(v);
+#else
+  std::string base;
+#if defined(__OSX__)
+  if(auto v = std::getenv("HOME"))
+    base = std::string(v) + "/Library/Caches";
+#else
+  if(auto v = std::getenv("XDG_CACHE_HOME"); v!=nullptr && v[0]=='/')
+    base = v;
+  else if(auto v = std::getenv("HOME"))
+    base = std::string(v) + "/.cache";
+#endif
+  root = TextCodec::toUtf16(base);
+#endif
+
+  if(root.empty())
+    root = u"cache"; else
+    root += u"/OpenGothic";
+  root += u"/";
+  root += sub;
+  return root;
+  }
@@ -7,4 +7,6 @@ namespace FileUtil {
   bool exists(const std::u16string& path);
   std::u16string caseInsensitiveSegment(std::u16string_view path, const char16_t* segment, Tempest::Dir::FileType type);
   std::u16string nestedPath(std::u16string_view gpath, const std::initializer_list<const char16_t*> &name, Tempest::Dir::FileType type);
+  // per-user cache directory of the game: %LOCALAPPDATA%, ~/Library/Caches or $XDG_CACHE_HOME; 'cache/' in cwd as fallback
+  std::u16string cacheDir(const char16_t* sub);
   }
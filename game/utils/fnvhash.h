@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+// 64-bit FNV-1a; used for cache keys and for checksums of on-disk cache entries.
+namespace FnvHash {
+  static constexpr uint64_t basis = 14695981039346656037ull;
+  static constexpr uint64_t prime = 1099511628211ull;
+
+  inline uint64_t mix(uint64_t h, uint64_t v) {
+    return (h ^ v) * prime;
+    }
+
+  // consumes 8 bytes per step, tail byte-wise
+  inline uint64_t bytes(uint64_t h, const void* ptr, size_t size) {
+    auto*  data = reinterpret_cast<const uint8_t*>(ptr);
+    size_t i    = 0;
+    for(; i+8<=size; i+=8) {
+      uint64_t v = 0;
+      std::memcpy(&v,data+i,8);
+      h = mix(h,v);
+      }
+    for(; i<size; ++i)
+      h = mix(h,data[i]);
+    return h;
+    }
+  }
@@ -2,10 +2,10 @@
 
 #include <Tempest/Size>
 #include "resources.h"
+#include "utils/fnvhash.h"
 
 using namespace Tempest;
 
-
 GthFont::GthFont(phoenix::buffer data, std::string_view ftex, const Color &cl)
   :fnt(phoenix::font::parse(data)), color(cl) {
   tex = Resources::loadTexture(ftex);
@@ -27,64 +27,106 @@ void GthFont::drawText(Painter &p, int bx, int by, int bw, int bh,
   }
 
 Size GthFont::processText(Painter* p, int bx, int by, int bw, int bh,
-                          std::string_view txtView, AlignFlag align, int firstLine) const {
-  const uint8_t* txt = reinterpret_cast<const uint8_t*>(txtView.data());
-
-  int   h  = pixelSize();
-  int   x  = bx, y=by-h;
-  float tw = float(tex->w());
-  float th = float(tex->h());
-
-  int   lwidth = 0;
+                          std::string_view txt, AlignFlag align, int firstLine) const {
+  auto lay = layout(bw,txt);
+  int  h   = pixelSize();
+  int  y   = by-h;
 
   Size ret = {0,0};
-  while(*txt) {
-    auto t    = getLine(txt,bw,lwidth);
-    auto sz   = textSize(txt,t);
-    auto next = t;
-
-    if(*next=='\n')
-      ++next;
-    while(*next==' ')
-      ++next; // lead spaces of next line
-
-    if(firstLine>0) {
-      txt = next;
-      --firstLine;
-      continue;
-      }
-    if(ret.h+sz.h>bh && bh>0) {
+  for(size_t i=size_t(std::max(firstLine,0)); i<lay->lines.size(); ++i) {
+    auto& ln = lay->lines[i];
+    if(ret.h+h>bh && bh>0) {
       break;
       }
 
-    ret.w  = std::max(ret.w,sz.w);
-    ret.h += sz.h;
+    ret.w  = std::max(ret.w,ln.width);
+    ret.h += h;
 
-    if(align!=NoAlign && align!=AlignLeft) {
-      int x1 = x;
-      if(align & AlignHCenter)
-        x1 = x + (bw-sz.w)/2;
-      if(align & AlignRight)
-        x1 = x + (bw-sz.w);
-      x = x1;
+    if(p!=nullptr) {
+      int x = bx;
+      if(align!=NoAlign && align!=AlignLeft) {
+        if(align & AlignHCenter)
+          x = bx + (bw-ln.width)/2;
+        if(align & AlignRight)
+          x = bx + (bw-ln.width);
+        }
+      for(size_t r=0; r<ln.count; ++r) {
+        auto& g = lay->glyphs[ln.glyph+r];
+        p->drawRect(x+g.x,y, g.w,h,
+                    g.u0,g.v0, g.u1,g.v1);
+        }
       }
+    y += h;
+    }
+
+  return ret;
+  }
+
+std::shared_ptr<const GthFont::Layout> GthFont::layout(int bw, std::string_view txt) const {
+  uint64_t key = FnvHash::basis;
+  for(auto c:txt)
+    key = FnvHash::mix(key,uint8_t(c));
+  key = FnvHash::mix(key,uint32_t(bw));
+
+  std::lock_guard<std::mutex> guard(cacheSync);
+  auto it = cache.find(key);
+  if(it!=cache.end() && it->second.layout->w==bw && it->second.layout->text==txt) {
+    it->second.lastUse = ++useCounter;
+    return it->second.layout;
+    }
+
+  if(it==cache.end() && cache.size()>=MaxCachedLayouts) {
+    auto old = cache.begin();
+    for(auto i=cache.begin(); i!=cache.end(); ++i)
+      if(i->second.lastUse<old->second.lastUse)
+        old = i;
+    cache.erase(old);
+    }
+
+  auto& e   = cache[key];
+  e.layout  = mkLayout(bw,txt);
+  e.lastUse = ++useCounter;
+  return e.layout;
+  }
+
+std::shared_ptr<const GthFont::Layout> GthFont::mkLayout(int bw, std::string_view txtView) const {
+  auto ret = std::make_shared<Layout>();
+  ret->text = std::string(txtView);
+  ret->w    = bw;
 
+  const uint8_t* txt = reinterpret_cast<const uint8_t*>(ret->text.c_str());
+  float tw     = float(tex->w());
+  float th     = float(tex->h());
+  int   lwidth = 0;
+
+  while(*txt) {
+    auto t = getLine(txt,bw,lwidth);
+
+    Line ln;
+    ln.glyph = ret->glyphs.size();
     for(auto i=txt; i!=t; ++i) {
       uint8_t id  = *i;
       auto&   uv1 = fnt.glyphs[id].uv[0];
       auto&   uv2 = fnt.glyphs[id].uv[1];
-      int     w   = fnt.glyphs[id].width;
 
-      if(p!=nullptr) {
-        p->drawRect(x,y, w,h,
-                    tw*uv1.x,th*uv1.y, tw*uv2.x,th*uv2.y);
-        }
-      x += w;
+      Glyph g;
+      g.x  = ln.width;
+      g.w  = int(fnt.glyphs[id].width);
+      g.u0 = tw*uv1.x;
+      g.v0 = th*uv1.y;
+      g.u1 = tw*uv2.x;
+      g.v1 = th*uv2.y;
+      ret->glyphs.push_back(g);
+      ln.width += g.w;
       }
-
-    txt = next;
-    x   = bx;
-    y  += sz.h;
+    ln.count = ret->glyphs.size()-ln.glyph;
+    ret->lines.push_back(ln);
+
+    if(*t=='\n')
+      ++t;
+    while(*t==' ')
+      ++t; // lead spaces of next line
+    txt = t;
     }
 
   return ret;
@@ -4,6 +4,10 @@
 
 #include <Tempest/Painter>
 
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
 class GthFont final {
   public:
     GthFont(phoenix::buffer data, std::string_view ftex, const Tempest::Color &cl);
@@ -21,10 +25,47 @@ class GthFont final {
     auto lineCount(int w, std::string_view txt) const -> int32_t;
 
   private:
+    struct Glyph {
+      int   x  = 0;
+      int   w  = 0;
+      float u0 = 0, v0 = 0;
+      float u1 = 0, v1 = 0;
+      };
+
+    struct Line {
+      size_t glyph = 0;
+      size_t count = 0;
+      int    width = 0;
+      };
+
+    // word-wrapped text; reused across frames, while text and wrap width stay the same
+    struct Layout {
+      std::string        text;
+      int                w = 0;
+      std::vector<Line>  lines;
+      std::vector<Glyph> glyphs;
+      };
+
+    struct CachedLayout {
+      std::shared_ptr<const Layout> layout;
+      uint64_t                      lastUse = 0;
+      };
+
+    enum {
+      MaxCachedLayouts = 128,
+      };
+
     phoenix::font             fnt;
     const Tempest::Texture2d* tex=nullptr;
     Tempest::Color            color;
 
+    mutable std::mutex                                cacheSync;
+    mutable std::unordered_map<uint64_t,CachedLayout> cache;
+    mutable uint64_t                                  useCounter = 0;
+
+    std::shared_ptr<const Layout> layout  (int bw, std::string_view txt) const;
+    std::shared_ptr<const Layout> mkLayout(int bw, std::string_view txt) const;
+
     const uint8_t* getLine(const uint8_t* txt, int bw, int &width) const;
     const uint8_t* getWord(const uint8_t* txt, int &width, int &space) const;
 
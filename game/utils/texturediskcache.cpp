@@ -0,0 +1,91 @@
+#include "texturediskcache.h"
+
+#include <cstring>
+
+#include "utils/fnvhash.h"
+
+using namespace Tempest;
+
+static char upper(char c) {
+  if('a'<=c && c<='z')
+    return char(c+'A'-'a');
+  return c;
+  }
+
+TextureDiskCache::TextureDiskCache(std::u16string dir, uint64_t archiveStamp)
+  :disk(std::move(dir),"texture cache",u".tex","OGTC",Version), stamp(archiveStamp) {
+  }
+
+uint64_t TextureDiskCache::archiveStamp(const std::u16string& archive, int64_t time, uint64_t prev) {
+  uint64_t h = (prev==0 ? FnvHash::basis : prev);
+  for(auto c:archive)
+    h = FnvHash::mix(h,uint64_t(c));
+  h = FnvHash::mix(h,uint64_t(time));
+  return h;
+  }
+
+bool TextureDiskCache::load(std::string_view name, size_t srcSize, Tempest::Pixmap& out) const {
+  if(name.size()>=MaxNameSize)
+    return false;
+
+  Meta   meta;
+  Pixmap pm;
+  bool   ok = disk.load(key(name),&meta,sizeof(meta),[&](size_t dataSize) -> void* {
+    if(meta.stamp!=stamp || meta.srcSize!=srcSize || meta.nameLen!=name.size())
+      return nullptr;
+    for(size_t i=0; i<name.size(); ++i)
+      if(upper(meta.name[i])!=upper(name[i]))
+        return nullptr; // hash collision
+
+    const auto   frm = TextureFormat(meta.format);
+    const size_t bpp = bytesPerPixel(frm);
+    if(bpp==0 || dataSize!=size_t(meta.w)*size_t(meta.h)*bpp)
+      return nullptr;
+    pm = Pixmap(meta.w,meta.h,frm);
+    return pm.data();
+    });
+  if(!ok)
+    return false;
+  out = std::move(pm);
+  return true;
+  }
+
+bool TextureDiskCache::store(std::string_view name, size_t srcSize, const Tempest::Pixmap& pm) const {
+  if(!isCacheable(pm) || name.size()>=MaxNameSize)
+    return false;
+
+  Meta meta;
+  meta.stamp   = stamp;
+  meta.srcSize = srcSize;
+  meta.w       = pm.w();
+  meta.h       = pm.h();
+  meta.format  = uint32_t(pm.format());
+  meta.nameLen = uint32_t(name.size());
+  std::memcpy(meta.name,name.data(),name.size());
+
+  const size_t dataSize = size_t(pm.w())*size_t(pm.h())*bytesPerPixel(pm.format());
+  return disk.store(key(name),&meta,sizeof(meta),pm.data(),dataSize);
+  }
+
+bool TextureDiskCache::isCacheable(const Tempest::Pixmap& pm) {
+  return pm.w()>0 && pm.h()>0 && bytesPerPixel(pm.format())>0;
+  }
+
+uint64_t TextureDiskCache::key(std::string_view name) {
+  uint64_t h = FnvHash::basis;
+  for(auto c:name)
+    h = FnvHash::mix(h,uint8_t(upper(c)));
+  return h;
+  }
+
+size_t TextureDiskCache::bytesPerPixel(Tempest::TextureFormat frm) {
+  switch(frm) {
+    case TextureFormat::R8:    return 1;
+    case TextureFormat::RG8:   return 2;
+    case TextureFormat::RGB8:  return 3;
+    case TextureFormat::RGBA8: return 4;
+    default:
+      // compressed and hdr formats are not cached
+      return 0;
+    }
+  }
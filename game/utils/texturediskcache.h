@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Tempest/Pixmap>
+
+#include <string>
+#include <string_view>
+
+#include "utils/diskcache.h"
+
+// Persistent storage of decoded, ready to upload, textures.
+// Works on cpu-side pixmaps only; no graphics device is required.
+class TextureDiskCache final {
+  public:
+    TextureDiskCache(std::u16string dir, uint64_t archiveStamp);
+
+    static uint64_t archiveStamp(const std::u16string& archive, int64_t time, uint64_t prev);
+
+    bool load (std::string_view name, size_t srcSize, Tempest::Pixmap& out) const;
+    bool store(std::string_view name, size_t srcSize, const Tempest::Pixmap& pm) const;
+
+    static bool isCacheable(const Tempest::Pixmap& pm);
+
+  private:
+    enum {
+      Version     = 2,
+      MaxNameSize = 256,
+      };
+
+    struct Meta {
+      uint64_t stamp   = 0;
+      uint64_t srcSize = 0;
+      uint32_t w       = 0;
+      uint32_t h       = 0;
+      uint32_t format  = 0;
+      uint32_t nameLen = 0;
+      char     name[MaxNameSize] = {};
+      };
+
+    static uint64_t key(std::string_view name);
+    static size_t   bytesPerPixel(Tempest::TextureFormat frm);
+
+    DiskCache disk;
+    uint64_t  stamp = 0;
+  };
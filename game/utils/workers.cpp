@@ -37,24 +37,169 @@ void Workers::setThreadName(const char* threadName){
 void Workers::setThreadName(const char* threadName) { (void)threadName; }
 #endif
 
+#if defined(_WIN32)
+#include <windows.h>
+
+void Workers::setThreadBackground() {
+  SetThreadPriority(GetCurrentThread(),THREAD_PRIORITY_BELOW_NORMAL);
+  }
+#elif defined(__APPLE__)
+#include <pthread.h>
+
+void Workers::setThreadBackground() {
+  pthread_set_qos_class_self_np(QOS_CLASS_UTILITY,0);
+  }
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+void Workers::setThreadBackground() {
+  // linux: nice value is per thread
+  setpriority(PRIO_PROCESS,id_t(syscall(SYS_gettid)),10);
+  }
+#else
+void Workers::setThreadBackground() {}
+#endif
+
 using namespace Tempest;
 
+static thread_local size_t threadId  = size_t(-1);
+static thread_local size_t stealSeed = 0;
+
+struct SpinLock {
+  std::atomic_flag flg = ATOMIC_FLAG_INIT;
+  void lock() {
+    while(flg.test_and_set(std::memory_order_acquire))
+      std::this_thread::yield();
+    }
+  void unlock() {
+    flg.clear(std::memory_order_release);
+    }
+  };
+
+struct Workers::Job final {
+  std::function<void()> func;
+  std::atomic<uint32_t> refs{1};
+  std::atomic<uint32_t> pending{0}; // unfinished dependencies
+  std::atomic<bool>     done{false};
+  SpinLock              succSync;
+  std::vector<Job*>     successors;
+  };
+
+// Chase-Lev deque: owner pushes and pops at the bottom, other threads steal from the top
+struct Workers::Deque final {
+  enum { Capacity = 4096 };
+
+  bool push(Job* job) {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    if(b-t>=Capacity)
+      return false;
+    buf[b & (Capacity-1)].store(job,std::memory_order_relaxed);
+    bottom.store(b+1,std::memory_order_release);
+    return true;
+    }
+
+  Job* pop() {
+    const int64_t b = bottom.load(std::memory_order_relaxed)-1;
+    bottom.store(b,std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if(t>b) {
+      bottom.store(b+1,std::memory_order_relaxed);
+      return nullptr;
+      }
+    Job* job = buf[b & (Capacity-1)].load(std::memory_order_relaxed);
+    if(t==b) {
+      // last element: race against thieves
+      if(!top.compare_exchange_strong(t,t+1,std::memory_order_seq_cst,std::memory_order_relaxed))
+        job = nullptr;
+      bottom.store(b+1,std::memory_order_relaxed);
+      }
+    return job;
+    }
+
+  Job* steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+    if(t>=b)
+      return nullptr;
+    Job* job = buf[t & (Capacity-1)].load(std::memory_order_relaxed);
+    if(!top.compare_exchange_strong(t,t+1,std::memory_order_seq_cst,std::memory_order_relaxed))
+      return nullptr;
+    return job;
+    }
+
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::atomic<Job*>                buf[Capacity] = {};
+  };
+
+struct Workers::Worker final {
+  Deque       queue;
+  std::thread th;
+  };
+
+Workers::Task::Task(const Task& other):job(other.job) {
+  if(job!=nullptr)
+    job->refs.fetch_add(1,std::memory_order_relaxed);
+  }
+
+Workers::Task::Task(Task&& other) noexcept :job(other.job) {
+  other.job = nullptr;
+  }
+
+Workers::Task::~Task() {
+  if(job!=nullptr)
+    release(job);
+  }
+
+Workers::Task& Workers::Task::operator =(const Task& other) {
+  Task tmp(other);
+  std::swap(job,tmp.job);
+  return *this;
+  }
+
+Workers::Task& Workers::Task::operator =(Task&& other) noexcept {
+  std::swap(job,other.job);
+  return *this;
+  }
+
+bool Workers::Task::isDone() const {
+  return job==nullptr || job->done.load(std::memory_order_acquire);
+  }
+
 Workers::Workers() {
-  size_t id=0;
-  for(auto& i:th) {
-    i = std::thread([this,id]() noexcept {
+  const size_t count = std::max<size_t>(1,maxThreads()-1u);
+  workers.resize(count);
+  for(auto& i:workers)
+    i.reset(new Worker());
+  // start threads only, when all of deques are in place
+  for(size_t id=0; id<count; ++id) {
+    workers[id]->th = std::thread([this,id]() noexcept {
       threadFunc(id);
       });
-    ++id;
     }
   }
 
 Workers::~Workers() {
-  running   = false;
-  workTasks = MAX_THREADS;
-  execWork();
-  for(auto& i:th)
-    i.join();
+  {
+    std::unique_lock<std::mutex> lck(sync);
+    running.store(false);
+    epoch.fetch_add(1);
+    workWait.notify_all();
+  }
+  for(auto& i:workers)
+    i->th.join();
+
+  // tasks, that never got to run
+  for(auto& i:workers)
+    while(auto job = i->queue.pop())
+      release(job);
+  for(auto job:inject)
+    release(job);
   }
 
 Workers &Workers::inst() {
@@ -62,52 +207,192 @@ Workers &Workers::inst() {
   return w;
   }
 
+void Workers::wait(const Task& t) {
+  if(t.job==nullptr)
+    return;
+  auto& w = inst();
+  while(!t.isDone()) {
+    if(!w.runOne())
+      std::this_thread::yield();
+    }
+  }
+
 void Workers::threadFunc(size_t id) {
   {
   string_frm tname("Workers [",int(id),"]");
   setThreadName(tname.c_str());
   }
+  threadId = id;
 
   while(true) {
+    if(runOne())
+      continue;
+
+    // short spin, before going to sleep: frame work comes in bursts
+    const uint32_t e     = epoch.load();
+    bool           found = false;
+    for(int i=0; i<64 && !found; ++i) {
+      found = runOne();
+      if(!found)
+        std::this_thread::yield();
+      }
+    if(found)
+      continue;
+
+    if(!running.load())
+      return;
+
+    sleeping.fetch_add(1);
     {
     std::unique_lock<std::mutex> lck(sync);
-    while(!workInc[id])
+    while(epoch.load()==e && running.load())
       workWait.wait(lck);
-    workInc[id]=false;
     }
+    sleeping.fetch_sub(1);
+    }
+  }
 
-    if(!running) {
-      workDone.fetch_add(1);
-      return;
-      }
+bool Workers::runOne() {
+  Job*         job = nullptr;
+  const size_t n   = workers.size();
 
-    size_t b = std::min((id  )*batchSize, workSize);
-    size_t e = std::min((id+1)*batchSize, workSize);
-    // Log::d("worker: id = ",id," [",b, ", ",e,"]");
+  if(threadId<n)
+    job = workers[threadId]->queue.pop();
 
-    if(b!=e) {
-      void* d = workSet + b*workEltSize;
-      workFunc(d,e-b);
+  if(job==nullptr && injectSize.load(std::memory_order_relaxed)>0) {
+    std::lock_guard<std::mutex> guard(injectSync);
+    if(!inject.empty()) {
+      job = inject.front();
+      inject.pop_front();
+      injectSize.fetch_sub(1,std::memory_order_relaxed);
       }
+    }
 
-    if(size_t(workDone.fetch_add(1)+1)==workTasks)
-      std::this_thread::yield();
+  if(job==nullptr) {
+    const size_t start = (threadId<n ? threadId+1 : stealSeed++);
+    for(size_t i=0; i<n && job==nullptr; ++i) {
+      const size_t victim = (start+i)%n;
+      if(victim!=threadId)
+        job = workers[victim]->queue.steal();
+      }
     }
+
+  if(job==nullptr)
+    return false;
+  exec(job);
+  return true;
   }
 
-void Workers::execWork() {
-  {
-    std::unique_lock<std::mutex> lck(sync);
-    for(size_t i=0; i<workTasks; ++i)
-      workInc[i]=true;
-    workWait.notify_all();
+void Workers::exec(Job* job) {
+  job->func();
+  complete(*job);
+  release(job);
   }
-  std::this_thread::yield();
 
-  while(true) {
-    int expect = int(workTasks);
-    if(workDone.compare_exchange_strong(expect,0,std::memory_order::acq_rel))
-      break;
+void Workers::complete(Job& job) {
+  job.func = nullptr;
+
+  std::vector<Job*> next;
+  job.succSync.lock();
+  job.done.store(true,std::memory_order_release);
+  next.swap(job.successors);
+  job.succSync.unlock();
+
+  for(auto i:next) {
+    // reference of the edge is passed to the queue
+    if(i->pending.fetch_sub(1,std::memory_order_acq_rel)==1)
+      schedule(i); else
+      release(i);
+    }
+  }
+
+void Workers::schedule(Job* job) {
+  if(threadId>=workers.size() || !workers[threadId]->queue.push(job)) {
+    std::lock_guard<std::mutex> guard(injectSync);
+    inject.push_back(job);
+    injectSize.fetch_add(1,std::memory_order_relaxed);
+    }
+  wake();
+  }
+
+void Workers::wake() {
+  epoch.fetch_add(1);
+  if(sleeping.load()>0) {
+    std::lock_guard<std::mutex> guard(sync);
+    workWait.notify_one();
+    }
+  }
+
+void Workers::release(Job* job) {
+  if(job->refs.fetch_sub(1,std::memory_order_acq_rel)==1)
+    delete job;
+  }
+
+void Workers::forkJoin(size_t count, const std::function<void(size_t)>& func) {
+  if(count==0)
+    return;
+  if(count==1) {
+    func(0);
+    return;
+    }
+
+  // indices are claimed from a shared counter; caller helps only with its own group,
+  // so it never picks up unrelated long tasks (loads) from the queues
+  struct Group final {
+    const std::function<void(size_t)>* func = nullptr;
+    size_t                             count = 0;
+    std::atomic<size_t>                next{0};
+    std::atomic<size_t>                left{0};
+
+    void run() {
+      while(true) {
+        const size_t i = next.fetch_add(1,std::memory_order_relaxed);
+        if(i>=count)
+          return;
+        // 'func' is alive: caller can't return, while index is in flight
+        (*func)(i);
+        left.fetch_sub(1,std::memory_order_release);
+        }
+      }
+    };
+
+  auto g = std::make_shared<Group>();
+  g->func  = &func;
+  g->count = count;
+  g->left.store(count);
+
+  for(size_t i=1; i<count; ++i) {
+    Job* job  = new Job();
+    job->func = [g]() { g->run(); };
+    schedule(job);
+    }
+
+  g->run();
+  while(g->left.load(std::memory_order_acquire)>0)
     std::this_thread::yield();
+  }
+
+Workers::Task Workers::implSpawn(std::function<void()>&& func, const Task* deps, size_t depsCount) {
+  Job* job  = new Job();
+  job->func = std::move(func);
+  // references: returned handle + spawn hold; hold keeps the task from starting, until all edges are in place
+  job->refs   .store(2);
+  job->pending.store(1);
+
+  for(size_t i=0; i<depsCount; ++i) {
+    Job* d = deps[i].job;
+    if(d==nullptr || d==job)
+      continue;
+    std::lock_guard<SpinLock> guard(d->succSync);
+    if(d->done.load(std::memory_order_relaxed))
+      continue;
+    job->refs   .fetch_add(1,std::memory_order_relaxed);
+    job->pending.fetch_add(1,std::memory_order_relaxed);
+    d->successors.push_back(job);
     }
+
+  if(job->pending.fetch_sub(1,std::memory_order_acq_rel)==1)
+    schedule(job); else
+    release(job);
+  return Task(job);
   }
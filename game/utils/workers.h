@@ -3,27 +3,71 @@
 #include <thread>
 #include <mutex>
 #include <vector>
+#include <deque>
+#include <memory>
 #include <functional>
 #include <atomic>
 #include <algorithm>
 #include <condition_variable>
+#include <initializer_list>
 #include <new>
 
 class Workers final {
+  private:
+    struct Job;
+    struct Deque;
+    struct Worker;
+
   public:
     Workers();
     ~Workers();
 
+    // handle to spawned task; dropping the handle doesn't cancel the task
+    class Task final {
+      public:
+        Task() = default;
+        Task(const Task& other);
+        Task(Task&& other) noexcept;
+        ~Task();
+
+        Task& operator = (const Task& other);
+        Task& operator = (Task&& other) noexcept;
+
+        bool isDone() const;
+
+      private:
+        explicit Task(Job* job):job(job) {}
+        Job* job = nullptr;
+
+      friend class Workers;
+      };
+
     static void setThreadName(const char* threadName);
+    // lowers priority of calling thread: for long jobs, that must not compete with frame work
+    static void setThreadBackground();
+
+    // task starts, once all of 'deps' are done
+    template<class F>
+    static Task spawn(F&& func, std::initializer_list<Task> deps = {}) {
+      return inst().implSpawn(std::function<void()>(std::forward<F>(func)),deps.begin(),deps.size());
+      }
+
+    template<class F>
+    static Task spawn(F&& func, const std::vector<Task>& deps) {
+      return inst().implSpawn(std::function<void()>(std::forward<F>(func)),deps.data(),deps.size());
+      }
+
+    // runs pending tasks on calling thread, until 't' is done
+    static void wait(const Task& t);
 
     template<class T,class F>
     static void parallelFor(T* b, T* e, const F& func) {
-      inst().runParallelFor(b,std::distance(b,e),std::thread::hardware_concurrency(),func);
+      inst().runParallelFor(b,size_t(std::distance(b,e)),maxThreads(),func);
       }
 
     template<class T,class F>
     static void parallelFor(std::vector<T>& data, const F& func) {
-      inst().runParallelFor(data.data(),data.size(),std::thread::hardware_concurrency(),func);
+      inst().runParallelFor(data.data(),data.size(),maxThreads(),func);
       }
 
     template<class T,class F>
@@ -33,100 +77,79 @@ class Workers final {
 
     template<class T,class F>
     static void parallelTasks(std::vector<T>& data, const F& func) {
-      inst().runParallelFor2(data.data(),data.size(),std::thread::hardware_concurrency(),func);
+      inst().runParallelFor2(data.data(),data.size(),maxThreads(),func);
       }
 
     template<class F>
     static void parallelTasks(size_t taskCount, const F& func) {
-      inst().runParallelTasks<F>(taskCount,func);
+      inst().forkJoin(taskCount,[&func](size_t id) {
+        func(uintptr_t(id));
+        });
       }
 
     static uint8_t maxThreads() {
       uint32_t th = std::thread::hardware_concurrency();
       if(th>MAX_THREADS)
         return MAX_THREADS;
-      return uint8_t(th);
+      return uint8_t(std::max<uint32_t>(th,1));
       }
 
   private:
-    enum { MAX_THREADS=16 };
-
-    void threadFunc(size_t id);
-    void execWork();
+    // bullet assigns up to 64 thread indices for the whole process
+    enum { MAX_THREADS=32 };
+
+    void   threadFunc(size_t id);
+    bool   runOne();
+    void   exec(Job* job);
+    void   complete(Job& job);
+    void   schedule(Job* job);
+    void   wake();
+    void   forkJoin(size_t count, const std::function<void(size_t)>& func);
+    Task   implSpawn(std::function<void()>&& func, const Task* deps, size_t depsCount);
+
+    static void release(Job* job);
     static Workers& inst();
 
     template<class T,class F>
     void runParallelFor(T* data, size_t sz, size_t maxTh, const F& func) {
-      workSet     = reinterpret_cast<uint8_t*>(data);
-      workSize    = sz;
-      workEltSize = sizeof(T);
-
-      workFunc = [&func](void* data,size_t sz) {
-        T* tdata = reinterpret_cast<T*>(data);
-        for(size_t i=0;i<sz;++i)
-          func(tdata[i]);
-        };
-
-      if(maxTh>MAX_THREADS)
-        workTasks = MAX_THREADS; else
-        workTasks = maxTh;
-
-      batchSize = std::max<size_t>(16,(sz+workTasks-1)/workTasks);
-      execWork();
+      if(sz==0)
+        return;
+      const size_t tasks = std::max<size_t>(1,std::min<size_t>(maxTh,(sz+15)/16));
+      const size_t batch = (sz+tasks-1)/tasks;
+      forkJoin(tasks,[data,sz,batch,&func](size_t id) {
+        const size_t b = std::min(id*batch,sz);
+        const size_t e = std::min(b+batch,sz);
+        for(size_t i=b; i<e; ++i)
+          func(data[i]);
+        });
       }
 
     template<class T,class F>
     void runParallelFor2(T* data, size_t sz, size_t maxTh, const F& func) {
-      workTasks   = std::min<size_t>(MAX_THREADS, sz);
-      workTasks   = std::min<size_t>(workTasks,  maxTh);
-      workSize    = workTasks;
-      batchSize   = 1;
-      workEltSize = 0;
-
-      workSet     = reinterpret_cast<uint8_t*>(data);
-      taskDone.store(0);
-      workFunc = [this, &func, sz](void* data, size_t /*sz*/) {
-        T* tdata = reinterpret_cast<T*>(data);
-        const size_t increment = (64+sizeof(T)-1)/sizeof(T);
+      const size_t        tasks     = std::min<size_t>(sz,maxTh);
+      const size_t        increment = (64+sizeof(T)-1)/sizeof(T);
+      std::atomic<size_t> next{0};
+      forkJoin(tasks,[data,sz,increment,&next,&func](size_t /*id*/) {
         while(true) {
-          size_t id = size_t(taskDone.fetch_add(increment));
-          for(size_t i=0;i<increment;++i) {
-            if(id+i<sz)
-              func(tdata[id+i]);
-            }
-
-          if(id+increment>=sz)
+          const size_t id = next.fetch_add(increment);
+          if(id>=sz)
             break;
+          const size_t e = std::min(id+increment,sz);
+          for(size_t i=id; i<e; ++i)
+            func(data[i]);
           }
-        };
-      execWork();
+        });
       }
 
-    template<class F>
-    void runParallelTasks(size_t taskCount, const F& func) {
-      workTasks   = taskCount;
-      workSize    = taskCount;
-      batchSize   = 1;
-      workSet     = nullptr;
-      workEltSize = 1;
-      workFunc = [&func](void* data, size_t sz) {
-        func(reinterpret_cast<uintptr_t>(data));
-        };
-      execWork();
-      }
-
-    std::thread                       th     [MAX_THREADS];
-    bool                              workInc[MAX_THREADS] = {};
-
-    bool                              running=true;
+    std::vector<std::unique_ptr<Worker>> workers;
 
-    uint8_t*                          workSet=nullptr;
-    size_t                            workSize=0, batchSize=0, workEltSize=0;
-    size_t                            workTasks=0;
-    std::function<void(void*,size_t)> workFunc;
+    std::mutex                           injectSync;
+    std::deque<Job*>                     inject;
+    std::atomic<size_t>                  injectSize{0};
 
-    std::mutex                        sync;
-    std::condition_variable           workWait;
-    std::atomic_int                   workDone{0};
-    std::atomic_int                   taskDone{0};
+    std::mutex                           sync;
+    std::condition_variable              workWait;
+    std::atomic<uint32_t>                epoch{0};
+    std::atomic<int>                     sleeping{0};
+    std::atomic<bool>                    running{true};
   };
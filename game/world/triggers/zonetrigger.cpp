@@ -4,11 +4,30 @@
 
 #include "world/objects/npc.h"
 #include "world/world.h"
+#include "game/gamesession.h"
 
 ZoneTrigger::ZoneTrigger(Vob* parent, World &world, const phoenix::vobs::trigger_change_level& trig, Flags flags)
   :AbstractTrigger(parent,world,trig,flags){
   levelName = trig.level_name;
   startVobName = trig.start_vob;
+  // poll distance to player, to start loading of next world ahead of time
+  enableTicks();
+  }
+
+void ZoneTrigger::tick(uint64_t dt) {
+  static const float    preloadDistance = 40*100; // 40 meters
+  static const uint64_t preloadPeriod   = 1000;
+
+  preloadTimer += dt;
+  if(preloadTimer<preloadPeriod)
+    return;
+  preloadTimer = 0;
+
+  auto pl = world.player();
+  if(pl==nullptr || !isEnabled())
+    return;
+  if((pl->position()-position()).quadLength()<preloadDistance*preloadDistance)
+    world.gameSession().preloadWorld(levelName);
   }
 
 void ZoneTrigger::onIntersect(Npc &n) {
@@ -7,8 +7,10 @@ class ZoneTrigger : public AbstractTrigger {
     ZoneTrigger(Vob* parent, World& world, const phoenix::vobs::trigger_change_level& data, Flags flags);
 
     void onIntersect(Npc& n) override;
+    void tick(uint64_t dt) override;
 
   private:
     std::string levelName;
     std::string startVobName;
+    uint64_t    preloadTimer = 0;
   };
@@ -4,9 +4,12 @@
 #include <future>
 #include <cctype>
 
+#include <Tempest/Application>
 #include <Tempest/Log>
 #include <Tempest/Painter>
 
+#include <unordered_set>
+
 #include "graphics/mesh/submesh/packedmesh.h"
 #include "graphics/visualfx.h"
 #include "world/objects/globalfx.h"
@@ -17,6 +20,8 @@
 #include "game/globaleffects.h"
 #include "game/serialize.h"
 #include "utils/string_frm.h"
+#include "utils/fileext.h"
+#include "utils/workers.h"
 #include "gothic.h"
 #include "focus.h"
 #include "resources.h"
@@ -62,34 +67,59 @@ const char* materialTag(phoenix::material_group src) {
   return "UD";
   }
 
-World::World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress)
+WorldPreload::~WorldPreload() {
+  }
+
+World::World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress,
+             std::unique_ptr<WorldPreload> pre)
   :wname(std::move(file)), game(game), wsound(game,*this), wobj(*this) {
-  const auto* entry = Resources::vdfsIndex().find(wname);
+  std::unique_ptr<phoenix::world>          zen;
+  std::unique_ptr<PackedMesh>              lnd;
+  std::unique_ptr<DynamicWorld::Landscape> physic;
+  if(pre!=nullptr) {
+    zen    = std::move(pre->zen);
+    lnd    = std::move(pre->landscape);
+    physic = std::move(pre->physic);
+    pre.reset();
+    }
 
-  if(entry == nullptr) {
+  const auto* entry = Resources::vdfsIndex().find(wname);
+  if(entry == nullptr && zen == nullptr) {
     Tempest::Log::e("unable to open Zen-file: \"",wname,"\"");
     return;
     }
 
   try {
-    auto buf = entry->open();
-    auto world = phoenix::world::parse(buf, version().game == 1 ? phoenix::game_version::gothic_1
-                                                                : phoenix::game_version::gothic_2);
+    const uint64_t time0 = Tempest::Application::tickCount();
+
+    if(zen==nullptr) {
+      auto buf = entry->open();
+      zen = std::make_unique<phoenix::world>(phoenix::world::parse(buf, version().game == 1 ? phoenix::game_version::gothic_1
+                                                                                           : phoenix::game_version::gothic_2));
+      }
+    auto& world = *zen;
+    const uint64_t timeParse = Tempest::Application::tickCount();
     loadProgress(20);
     auto& worldMesh = world.world_mesh;
 
     auto wdynamicFut = std::async(std::launch::async, [&]() {
       Workers::setThreadName("Loading: BVH thread");
-      return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh));
+      return std::unique_ptr<DynamicWorld>(new DynamicWorld(*this,worldMesh,std::move(physic)));
       });
     auto wviewFut = std::async(std::launch::async, [&]() {
       Workers::setThreadName("Loading: PackedMesh thread");
-      PackedMesh vmesh(worldMesh,PackedMesh::PK_VisualLnd);
-      return std::unique_ptr<WorldView>(new WorldView(*this,vmesh));
+      if(lnd==nullptr)
+        lnd.reset(new PackedMesh(worldMesh,PackedMesh::PK_VisualLnd));
+      return std::unique_ptr<WorldView>(new WorldView(*this,*lnd));
       });
 
     loadProgress(30);
 
+    // decode assets on workers, while landscape is built; vobs are created against warm caches later
+    std::vector<Workers::Task> assets;
+    for(auto& name:collectAssets(world.world_vobs))
+      assets.push_back(preloadAssetAsync(name));
+
     {
       bsp.nodes             = std::move(world.world_bsp_tree.nodes);
       bsp.sectors           = std::move(world.world_bsp_tree.sectors);
@@ -100,9 +130,16 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
     loadProgress(50);
 
     wview = wviewFut.get();
+    lnd.reset();
     loadProgress(60);
 
     wdynamic = wdynamicFut.get();
+    const uint64_t timeLnd = Tempest::Application::tickCount();
+
+    for(auto& i:assets)
+      Workers::wait(i);
+    assets.clear();
+    const uint64_t timeAssets = Tempest::Application::tickCount();
     loadProgress(70);
 
     globFx.reset(new GlobalEffects(*this));
@@ -111,7 +148,13 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
       wobj.addRoot(vob,startup);
 
     wmatrix->buildIndex();
+    const uint64_t timeVobs = Tempest::Application::tickCount();
     loadProgress(100);
+
+    Tempest::Log::i("World loading time[",wname,"]: parse=",  size_t(timeParse -time0),     "ms",
+                    " landscape=",size_t(timeLnd   -timeParse), "ms",
+                    " assets=",   size_t(timeAssets-timeLnd),   "ms",
+                    " vobs=",     size_t(timeVobs  -timeAssets),"ms");
     }
   catch(...) {
     Tempest::Log::e("unable to load landscape mesh");
@@ -122,6 +165,113 @@ World::World(GameSession& game, std::string_view file, bool startup, std::functi
 World::~World() {
   }
 
+static void collectAssets(const std::vector<std::unique_ptr<phoenix::vob>>& vobs, std::unordered_set<std::string>& ret) {
+  // mirrors visual types handled by ObjVisual
+  for(auto& i:vobs) {
+    auto& name = i->visual_name;
+    if(FileExt::hasExt(name,"3DS") || FileExt::hasExt(name,"MDS") || FileExt::hasExt(name,"MMS") || FileExt::hasExt(name,"ZEN")) {
+      ret.insert(name);
+      }
+    else if(FileExt::hasExt(name,"ASC")) {
+      auto visual = name;
+      FileExt::exchangeExt(visual,"ASC","MDL");
+      ret.insert(std::move(visual));
+      }
+    else if(FileExt::hasExt(name,"TGA") && i->sprite_camera_facing_mode==phoenix::sprite_alignment::none) {
+      ret.insert(name);
+      }
+    collectAssets(i->children,ret);
+    }
+  }
+
+std::vector<std::string> World::collectAssets(const std::vector<std::unique_ptr<phoenix::vob>>& vobs) {
+  std::unordered_set<std::string> assets;
+  ::collectAssets(vobs,assets);
+  return std::vector<std::string>(assets.begin(),assets.end());
+  }
+
+std::unique_ptr<WorldPreload> World::preload(std::string_view file, const std::atomic_bool& cancel, size_t budget) {
+  auto resident = [](){
+    size_t ret = 0;
+    for(auto& i:Resources::cacheStats())
+      ret += i.bytes;
+    return ret;
+    };
+
+  // everything preload keeps counts against the budget; stages are estimated before they are built
+  size_t used = 0;
+  auto   fits = [&used,budget](size_t bytes) {
+    if(used+bytes>budget)
+      return false;
+    used += bytes;
+    return true;
+    };
+
+  auto ret  = std::make_unique<WorldPreload>();
+  ret->name = std::string(file);
+
+  const auto* entry = Resources::vdfsIndex().find(file);
+  if(entry==nullptr)
+    return nullptr;
+
+  auto buf = entry->open();
+  // parsed zen is about as large, as the file
+  if(!fits(buf.limit()))
+    return nullptr;
+  ret->zen = std::make_unique<phoenix::world>(phoenix::world::parse(buf, Gothic::inst().version().game == 1 ? phoenix::game_version::gothic_1
+                                                                                                          : phoenix::game_version::gothic_2));
+  if(cancel.load())
+    return ret;
+
+  // upper bounds: one vertex per polygon corner; physic adds bvh nodes, about two per triangle
+  const size_t corners = ret->zen->world_mesh.polygons.vertex_indices.size();
+  if(!fits(corners*(sizeof(Resources::Vertex)+sizeof(uint32_t))))
+    return ret;
+  ret->landscape.reset(new PackedMesh(ret->zen->world_mesh,PackedMesh::PK_VisualLnd));
+  if(cancel.load())
+    return ret;
+
+  if(!fits(corners*(4*sizeof(float)+sizeof(uint32_t)) + (corners/3)*2*32))
+    return ret;
+  ret->physic.reset(new DynamicWorld::Landscape(ret->zen->world_mesh));
+
+  // serial on purpose: Workers are busy with the running world
+  const size_t base = resident();
+  for(auto& i:collectAssets(ret->zen->world_vobs)) {
+    if(cancel.load())
+      break;
+    const size_t r = resident();
+    if(r>base && used+(r-base)>budget)
+      break;
+    preloadAsset(i);
+    }
+  return ret;
+  }
+
+Workers::Task World::preloadAssetAsync(std::string_view name) {
+  if(FileExt::hasExt(name,"TGA"))
+    return Resources::loadTextureAsync(name);
+  if(!FileExt::hasExt(name,"ZEN"))
+    return Resources::loadMeshAsync(name);
+  return Workers::spawn([cname = std::string(name)](){
+    preloadAsset(cname);
+    });
+  }
+
+void World::preloadAsset(std::string_view name) {
+  try {
+    if(FileExt::hasExt(name,"ZEN"))
+      Resources::loadVobBundle(name);
+    else if(FileExt::hasExt(name,"TGA"))
+      Resources::loadTexture(name,true);
+    else
+      Resources::loadMesh(name);
+    }
+  catch(...) {
+    // not fatal here: error will be reported, when vob is actually created
+    }
+  }
+
 void World::createPlayer(std::string_view cls) {
   size_t id = script().findSymbolIndex(cls);
   if(id==size_t(-1))
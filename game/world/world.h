@@ -5,6 +5,7 @@
 #include <Tempest/Matrix4x4>
 #include <string>
 #include <functional>
+#include <atomic>
 
 #include <phoenix/world.hh>
 
@@ -17,6 +18,7 @@
 #include "worldsound.h"
 #include "waypoint.h"
 #include "waymatrix.h"
+#include "utils/workers.h"
 
 class GameSession;
 class Focus;
@@ -27,12 +29,23 @@ class ParticleFx;
 class Interactive;
 class VersionInfo;
 class GlobalFx;
+class PackedMesh;
+
+// static parts of a world, that can be prepared ahead of time
+struct WorldPreload final {
+  ~WorldPreload();
+  std::string                              name;
+  std::unique_ptr<phoenix::world>          zen;
+  std::unique_ptr<PackedMesh>              landscape;
+  std::unique_ptr<DynamicWorld::Landscape> physic;
+  };
 
 class World final {
   public:
     World()=delete;
     World(const World&)=delete;
-    World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress);
+    World(GameSession& game, std::string_view file, bool startup, std::function<void(int)> loadProgress,
+          std::unique_ptr<WorldPreload> pre = nullptr);
     ~World();
 
     void                 createPlayer(std::string_view cls);
@@ -41,6 +54,11 @@ class World final {
     void                 postInit();
     std::string_view     name() const { return wname; }
 
+    static auto          collectAssets(const std::vector<std::unique_ptr<phoenix::vob>>& vobs) -> std::vector<std::string>;
+    static void          preloadAsset (std::string_view name);
+    static auto          preloadAssetAsync(std::string_view name) -> Workers::Task;
+    static auto          preload(std::string_view file, const std::atomic_bool& cancel, size_t budget) -> std::unique_ptr<WorldPreload>;
+
     void                 load(Serialize& fin );
     void                 save(Serialize& fout);
 
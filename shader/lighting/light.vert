@@ -22,6 +22,10 @@ layout(binding = 4, std140) readonly buffer SsboLighting {
   LightSource data[];
   } lights;
 
+layout(binding = 11, std430) readonly buffer SsboVisible {
+  uint id[];
+  } visible;
+
 layout(location = 0) in  vec3 inPos;
 
 layout(location = 0) out vec4 cenPosition;
@@ -48,7 +52,7 @@ bool testFrustrum(in vec3 at, in float R){
   }
 
 void main(void) {
-  LightSource light = lights.data[gl_InstanceIndex];
+  LightSource light = lights.data[visible.id[gl_InstanceIndex]];
 
   if(!testFrustrum(light.pos,light.range)) {
     // skip invisible lights, make sure that they don't turn into FQS